@@ -24,7 +24,8 @@
 #  graybat_LIBRARIES       - libraries to link against
 #  graybat_GENERATED_FILES - files to add to targets using Graybat
 #  graybat_DEFINTIONS      - compile definitions provided by graybat
-#                            (graybat_ZMQ_CP_ENABLED, graybat_BMPI_CP_ENABLED)
+#                            (graybat_ZMQ_CP_ENABLED, graybat_BMPI_CP_ENABLED,
+#                             graybat_TCP_CP_ENABLED)
 
 ###############################################################################
 # graybat
@@ -136,6 +137,12 @@ if(ZMQ_FOUND AND GRPC_FOUND AND Protobuf_FOUND)
     SET(graybat_ZMQ_CP_ENABLED TRUE)
 endif()
 
+# The TCP policy waits for its streams with epoll
+if(GRPC_FOUND AND Protobuf_FOUND AND CMAKE_SYSTEM_NAME STREQUAL "Linux")
+    LIST(APPEND graybat_DEFINITIONS "graybat_TCP_CP_ENABLED")
+    SET(graybat_TCP_CP_ENABLED TRUE)
+endif()
+
 ###############################################################################
 # FindPackage options
 ###############################################################################
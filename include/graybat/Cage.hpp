@@ -26,6 +26,7 @@
 
 // STL
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <exception>
 #include <map>
@@ -34,6 +35,9 @@
 #include <stdexcept>
 #include <tuple>
 #include <future>
+#include <functional>
+#include <type_traits>
+#include <typeinfo>
 
 // Boost
 #include <boost/core/ignore_unused.hpp>
@@ -47,8 +51,8 @@
 #include <graybat/graphPolicy/Traits.hpp>
 #include <graybat/pattern/None.hpp>
 #include <graybat/serializationPolicy/Forward.hpp>
-#include <graybat/utils/exclusivePrefixSum.hpp>
 #include <graybat/threading/AsioThreadPool.hpp>
+#include <graybat/utils/elementwiseReduce.hpp>
 
 namespace graybat {
 
@@ -81,6 +85,7 @@ struct Cage {
     using Type = Cage<CommunicationPolicy, GraphPolicy, SerializationPolicy>;
 
     using VAddr = graybat::communicationPolicy::VAddr<CommunicationPolicy>;
+    using Tag = graybat::communicationPolicy::Tag<CommunicationPolicy>;
     using Context = graybat::communicationPolicy::Context<CommunicationPolicy>;
     using CPEvent = graybat::communicationPolicy::Event<CommunicationPolicy>;
     using CPConfig = graybat::communicationPolicy::Config<CommunicationPolicy>;
@@ -227,7 +232,7 @@ struct Cage {
      *        vertices that are hosted by the peer with
      *        *vAddr*
      */
-    auto getVerticesHostedBy(const VAddr& vAddr) -> std::vector<Vertex>;
+    auto getVerticesHostedBy(const VAddr& vAddr) -> const std::vector<Vertex>&;
 
     /**
      * @brief Return the vertices that are hosted by this cage.
@@ -376,6 +381,75 @@ struct Cage {
     /// requires concept::ContiguousContainer<T_Recv>
     void allGather(const Vertex& srcVertex, T_Send sendData, T_Recv& recvData, const bool reorder);
 
+    /**
+     * @brief Reduction of the data of all hosted vertices at once.
+     *        The contributions are reduced locally and then reduced
+     *        by a single call of the communicator.
+     *
+     * @param[in]  rootVertex    vertex that receives the result
+     * @param[in]  op            binary operator used for reduction
+     * @param[in]  contributions range of (vertex, data) pairs, one
+     *                           for each hosted vertex
+     * @param[out] recvData      reduced data, only valid on the host
+     *                           of the *rootVertex*
+     */
+    template <typename T_Contributions, typename T_Recv, typename T_Op>
+    /// requires concept::Range<T_Contributions> of pair<Vertex, ContiguousContainer>
+    /// requires concept::ContiguousContainer<T_Recv>
+    /// requires concept::BinaeryOperator<T_Op>
+    void reduce(
+        const Vertex& rootVertex, T_Op op, const T_Contributions& contributions, T_Recv& recvData);
+
+    /**
+     * @brief Reduction of the data of all hosted vertices at once,
+     *        the result is received by all peers.
+     *
+     * @param[in]  op            binary operator used for reduction
+     * @param[in]  contributions range of (vertex, data) pairs, one
+     *                           for each hosted vertex
+     * @param[out] recvData      reduced data
+     */
+    template <typename T_Contributions, typename T_Recv, typename T_Op>
+    /// requires concept::Range<T_Contributions> of pair<Vertex, ContiguousContainer>
+    /// requires concept::ContiguousContainer<T_Recv>
+    /// requires concept::BinaeryOperator<T_Op>
+    void allReduce(T_Op op, const T_Contributions& contributions, T_Recv& recvData);
+
+    /**
+     * @brief Gathers the data of all hosted vertices at once by a
+     *        single call of the communicator.
+     *
+     * @param[in]  rootVertex    vertex that receives the gathered data
+     * @param[in]  contributions range of (vertex, data) pairs in the
+     *                           order of getHostedVertices()
+     * @param[out] recvData      gathered data, only valid on the host
+     *                           of the *rootVertex*
+     * @param[in]  reorder       order *recvData* by vertex id
+     */
+    template <typename T_Contributions, typename T_Recv>
+    /// requires concept::Range<T_Contributions> of pair<Vertex, ContiguousContainer>
+    /// requires concept::ResizeableContainer<T_Recv>
+    void gather(
+        const Vertex& rootVertex,
+        const T_Contributions& contributions,
+        T_Recv& recvData,
+        const bool reorder);
+
+    /**
+     * @brief Gathers the data of all hosted vertices at once by a
+     *        single call of the communicator, all peers receive the
+     *        gathered data.
+     *
+     * @param[in]  contributions range of (vertex, data) pairs in the
+     *                           order of getHostedVertices()
+     * @param[out] recvData      gathered data
+     * @param[in]  reorder       order *recvData* by vertex id
+     */
+    template <typename T_Contributions, typename T_Recv>
+    /// requires concept::Range<T_Contributions> of pair<Vertex, ContiguousContainer>
+    /// requires concept::ResizeableContainer<T_Recv>
+    void allGather(const T_Contributions& contributions, T_Recv& recvData, const bool reorder);
+
     /**
      * @brief Spread data from a vertex to all adjacent vertices
      *        connected by an outgoing edge (async).
@@ -385,6 +459,11 @@ struct Cage {
      * @param[out] events where the events for this async operations will be
      * inserted.
      *
+     * The data is serialized once, the events of all out edges share
+     * the serialized buffer and release it when the last of them is
+     * destroyed. Edges to vertices of the same peer are multicast,
+     * thus the data is transmitted once per peer if the
+     * communication policy supports it.
      */
     template <typename T>
     /// requires concept::ContiguousContainer<T>
@@ -414,11 +493,107 @@ struct Cage {
     /// requires concept::ContiguousContainer<T>
     template <typename T> void collect(const Vertex& vertex, T& data);
 
+    /**
+     * @brief Exchanges equally sized chunks of *sendData* between all
+     *        peers hosting vertices. The ith chunk is sent to the peer
+     *        with VAddr i (see locateVertex()).
+     *
+     * @param[in]  sendData one chunk of data for each peer
+     * @param[out] recvData one chunk of data from each peer
+     *
+     */
+    template <typename T_Send, typename T_Recv>
+    /// requires concept::ContiguousContainer<T_Send>
+    /// requires concept::ContiguousContainer<T_Recv>
+    void allToAll(const T_Send& sendData, T_Recv& recvData);
+
+    /**
+     * @brief Exchanges chunks of *sendData* with varying size between all
+     *        peers hosting vertices. sendCount[i] elements are sent to the
+     *        peer with VAddr i (see locateVertex()).
+     *
+     * @param[in]  sendData  data for all peers, ordered by VAddr
+     * @param[in]  sendCount number of elements for each peer
+     * @param[out] recvData  data from all peers, ordered by VAddr
+     * @param[out] recvCount number of elements received from each peer
+     *
+     */
+    template <typename T_Send, typename T_Recv>
+    /// requires concept::ContiguousContainer<T_Send>
+    /// requires concept::ResizeableContainer<T_Recv>
+    void allToAllVar(
+        const T_Send& sendData,
+        const std::vector<unsigned>& sendCount,
+        T_Recv& recvData,
+        std::vector<unsigned>& recvCount);
+
+    /**
+     * @brief Sparse exchange of data between peers hosting vertices.
+     *        Each peer sends data to a few peers only and does not
+     *        need to know which peers will send data to itself.
+     *        Useful for vertex migration and irregular communication.
+     *
+     * @param[in]  sendData maps VAddr of destination peers to data
+     * @param[out] recvData maps VAddr of source peers to received data
+     *
+     */
+    template <typename T_Send, typename T_Recv>
+    /// requires concept::ContiguousContainer<T_Send>
+    /// requires concept::ResizeableContainer<T_Recv>
+    void sparseExchange(const std::map<VAddr, T_Send>& sendData, std::map<VAddr, T_Recv>& recvData);
+
+    /**
+     * @brief Inclusive prefix reduction with *op* over the peers hosting
+     *        vertices, ordered by VAddr. Useful to compute global
+     *        offsets e.g. for parallel output or vertex renumbering.
+     *
+     * @param[in]  op       associative binary operator
+     * @param[in]  sendData data this peer contributes
+     * @param[out] recvData reduction of the data of all peers up to this peer
+     *
+     */
+    template <typename T_Send, typename T_Recv, typename T_Op>
+    /// requires concept::ContiguousContainer<T_Send>
+    /// requires concept::ContiguousContainer<T_Recv>
+    void scan(T_Op op, const T_Send& sendData, T_Recv& recvData);
+
+    /**
+     * @brief Exclusive prefix reduction with *op* over the peers hosting
+     *        vertices, ordered by VAddr. *recvData* of the peer with
+     *        VAddr 0 is left unchanged.
+     *
+     * @param[in]  op       associative binary operator
+     * @param[in]  sendData data this peer contributes
+     * @param[out] recvData reduction of the data of all peers before this peer
+     *
+     */
+    template <typename T_Send, typename T_Recv, typename T_Op>
+    /// requires concept::ContiguousContainer<T_Send>
+    /// requires concept::ContiguousContainer<T_Recv>
+    void exscan(T_Op op, const T_Send& sendData, T_Recv& recvData);
+
     void synchronize();
 
+    /**
+     * @brief Sends all messages the communication policy holds back
+     *        to batch them, e.g. before waiting on a peer.
+     */
+    void flush();
+
     /** @} */
 
   private:
+    /**
+     * @brief Type an event keeps of serialized data, serialization
+     *        policies which return references keep nothing but a
+     *        reference to the caller owned data.
+     */
+    template <typename T_Serialized>
+    using Kept = typename std::conditional<
+        std::is_reference<T_Serialized>::value,
+        std::reference_wrapper<typename std::remove_reference<T_Serialized>::type>,
+        T_Serialized>::type;
+
     /***************************************************************************
     *
     * Methods
@@ -455,15 +630,37 @@ struct Cage {
     // List of vertices of the hosts
     std::map<VAddr, std::vector<Vertex>> peerMap;
 
+    // Vertex ids in the order their data is received by gather,
+    // precomputed for each distribution by announce()
+    std::vector<VertexID> gatherOrder;
+
+    // Number of vertices hosted by each peer of the graphContext
+    std::vector<unsigned> nVerticesOfPeer;
+
+    // Receive buffer of the reordering gather and allGather, kept
+    // while the value type stays the same
+    std::shared_ptr<void> gatherBuffer;
+    const std::type_info* gatherBufferType = nullptr;
+
+    template <typename T> std::vector<T>& getGatherBuffer()
+    {
+        if (gatherBufferType != &typeid(T)) {
+            gatherBuffer = std::make_shared<std::vector<T>>();
+            gatherBufferType = &typeid(T);
+        }
+        return *std::static_pointer_cast<std::vector<T>>(gatherBuffer);
+    }
+
     /**
      * @brief Reorders data received from vertices into vertex id order.
+     *        Applies the precomputed gatherOrder in a single pass.
      *
      */
-    template <class T>
+    template <typename T_Data, typename T_Reordered>
     void reorder(
-        const std::vector<T>& data,
+        const T_Data& data,
         const std::vector<unsigned>& recvCount,
-        std::vector<T>& dataReordered);
+        T_Reordered& dataReordered);
 };
 
 //!
@@ -632,6 +829,11 @@ auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::announce(
 
     graphContext = communicator->splitContext(vertices.size(), oldContext);
 
+    // Hosts of the previous graph are stale, peers that are no
+    // member of the new context would find their old vertices
+    vertexMap.clear();
+    peerMap.clear();
+
     // Each peer announces the vertices it hosts
     if (graphContext.valid()) {
         std::array<unsigned, 1> nVertices{ { static_cast<unsigned>(vertices.size()) } };
@@ -642,10 +844,11 @@ auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::announce(
         });
 
         // Send hostedVertices to all other peers
+        std::vector<CPEvent> events;
         for (auto const& vAddr : graphContext) {
             assert(nVertices[0] != 0);
-            communicator->asyncSend(vAddr, 0, graphContext, nVertices);
-            communicator->asyncSend(vAddr, 0, graphContext, vertexIDs);
+            events.push_back(communicator->asyncSend(vAddr, 0, graphContext, nVertices));
+            events.push_back(communicator->asyncSend(vAddr, 0, graphContext, vertexIDs));
         }
 
         // Recv hostedVertices from all other peers
@@ -662,6 +865,20 @@ auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::announce(
             }
             peerMap[vAddr] = remoteVertices;
         }
+
+        for (CPEvent& e : events) {
+            e.wait();
+        }
+
+        // Data of gathers arrives ordered by VAddr and hosted vertices
+        gatherOrder.clear();
+        nVerticesOfPeer.assign(graphContext.size(), 0);
+        for (auto const& vAddr : graphContext) {
+            for (Vertex const& v : peerMap[vAddr]) {
+                gatherOrder.push_back(v.id);
+            }
+            nVerticesOfPeer[vAddr] = static_cast<unsigned>(peerMap[vAddr].size());
+        }
     }
 }
 
@@ -682,7 +899,7 @@ auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::locateVert
 
 template <typename T_CommunicationPolicy, typename T_GraphPolicy, typename SerializationPolicy>
 auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::getVerticesHostedBy(
-    const VAddr& vAddr) -> std::vector<Vertex>
+    const VAddr& vAddr) -> const std::vector<Vertex>&
 {
     return peerMap[vAddr];
 }
@@ -700,7 +917,7 @@ auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::isHosting(
 {
     VAddr vaddr = graphContext.getVAddr();
 
-    for (Vertex& v : getVerticesHostedBy(vaddr)) {
+    for (const Vertex& v : getVerticesHostedBy(vaddr)) {
         if (vertex.id == v.id)
             return true;
     }
@@ -746,7 +963,7 @@ auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::send(
 
     decltype(auto) serialized = SerializationPolicy::serialize(data);
     CPEvent e = communicator->asyncSend(destVAddr, edge.id, graphContext, serialized);
-    events.push_back({ e, [serialized]() {} });
+    events.emplace_back(std::move(e), [kept = Kept<decltype(serialized)>(serialized)]() {});
 }
 
 template <typename T_CommunicationPolicy, typename T_GraphPolicy, typename SerializationPolicy>
@@ -787,7 +1004,10 @@ auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::recv(
     decltype(auto) skeleton = SerializationPolicy::prepare(data);
     CPEvent e = communicator->asyncRecv(srcVAddr, edge.id, graphContext, skeleton);
 
-    events.push_back({ e, [&data, skeleton]() { SerializationPolicy::restore(data, skeleton); } });
+    using Skeleton = typename std::remove_reference<decltype(skeleton)>::type;
+    events.emplace_back(std::move(e), [&data, kept = Kept<decltype(skeleton)>(skeleton)]() {
+        SerializationPolicy::restore(data, static_cast<Skeleton const&>(kept));
+    });
 }
 
 //!
@@ -854,9 +1074,7 @@ auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::reduce(
     }
 
     // Reduce locally
-    for (std::size_t i = 0; i < reduce.size(); ++i) {
-        reduce[i] = op(reduce[i], sendData.data()[i]);
-    }
+    utils::elementwiseReduce(op, sendData.data(), reduce.data(), reduce.size());
 
     // Remember pointer of recvData from rootVertex
     if (rootVertex.id == srcVertex.id) {
@@ -905,9 +1123,7 @@ auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::allReduce(
     }
 
     // Reduce locally
-    for (std::size_t i = 0; i < reduce.size(); ++i) {
-        reduce[i] = op(reduce[i], sendData.data()[i]);
-    }
+    utils::elementwiseReduce(op, sendData.data(), reduce.data(), reduce.size());
 
     // Finally start reduction
     if (vertexCount == vertices.size()) {
@@ -964,16 +1180,18 @@ auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::gather(
     if (nGatherCalls == hostedVertices.size()) {
         std::vector<unsigned> recvCount;
         if (peerHostsRootVertex) {
-            communicator->gatherVar(rootVAddr, context, gather, *rootRecvData, recvCount);
 
             // Reorder the received data, so that the data
             // is in vertex id order. This operation is no
             // sorting since the mapping is known before.
             if (reorder) {
-                std::vector<RecvValueType> recvDataReordered(recvData.size());
-                Cage::reorder(*rootRecvData, recvCount, recvDataReordered);
-                std::copy(
-                    recvDataReordered.begin(), recvDataReordered.end(), rootRecvData->begin());
+                std::vector<RecvValueType>& recvDataUnordered
+                    = getGatherBuffer<RecvValueType>();
+                communicator->gatherVar(rootVAddr, context, gather, recvDataUnordered, recvCount);
+                rootRecvData->resize(recvDataUnordered.size());
+                Cage::reorder(recvDataUnordered, recvCount, *rootRecvData);
+            } else {
+                communicator->gatherVar(rootVAddr, context, gather, *rootRecvData, recvCount);
             }
 
         } else {
@@ -982,6 +1200,7 @@ auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::gather(
 
         gather.clear();
         nGatherCalls = 0;
+        peerHostsRootVertex = false;
     }
 }
 
@@ -1009,13 +1228,14 @@ auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::allGather(
     if (nGatherCalls == hostedVertices.size()) {
         std::vector<unsigned> recvCount;
 
-        communicator->allGatherVar(context, gather, *(recvDatas[0]), recvCount);
-
         // Reordering code
         if (reorder) {
-            std::vector<RecvValueType> recvDataReordered(recvData.size());
-            Cage::reorder(*(recvDatas[0]), recvCount, recvDataReordered);
-            std::copy(recvDataReordered.begin(), recvDataReordered.end(), recvDatas[0]->begin());
+            std::vector<RecvValueType>& recvDataUnordered = getGatherBuffer<RecvValueType>();
+            communicator->allGatherVar(context, gather, recvDataUnordered, recvCount);
+            recvDatas[0]->resize(recvDataUnordered.size());
+            Cage::reorder(recvDataUnordered, recvCount, *(recvDatas[0]));
+        } else {
+            communicator->allGatherVar(context, gather, *(recvDatas[0]), recvCount);
         }
 
         // Distribute Received Data to Hosted Vertices
@@ -1026,6 +1246,156 @@ auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::allGather(
         }
 
         gather.clear();
+        recvDatas.clear();
+        nGatherCalls = 0;
+    }
+}
+
+template <typename T_CommunicationPolicy, typename T_GraphPolicy, typename SerializationPolicy>
+template <typename T_Contributions, typename T_Recv, typename T_Op>
+auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::reduce(
+    const Vertex& rootVertex, T_Op op, const T_Contributions& contributions, T_Recv& recvData)
+    -> void
+{
+    using value_type = typename T_Recv::value_type;
+
+    // Peers without hosted vertices do not take part
+    if (!graphContext.valid()) {
+        return;
+    }
+
+    VAddr rootVAddr = locateVertex(rootVertex);
+    Context context = graphContext;
+
+    // Reduce locally, starting with the data of the first vertex
+    auto contribution = std::begin(contributions);
+    assert(contribution != std::end(contributions));
+    std::vector<value_type> reduce(
+        contribution->second.data(), contribution->second.data() + contribution->second.size());
+
+    for (++contribution; contribution != std::end(contributions); ++contribution) {
+        assert(contribution->second.size() == reduce.size());
+        utils::elementwiseReduce(op, contribution->second.data(), reduce.data(), reduce.size());
+    }
+
+    decltype(auto) serialized = SerializationPolicy::serialize(reduce);
+    if (rootVAddr == context.getVAddr()) {
+        decltype(auto) skeleton = SerializationPolicy::prepare(recvData);
+        communicator->reduce(rootVAddr, context, op, serialized, skeleton);
+        SerializationPolicy::restore(recvData, skeleton);
+    } else {
+        communicator->reduce(rootVAddr, context, op, serialized, serialized);
+    }
+}
+
+template <typename T_CommunicationPolicy, typename T_GraphPolicy, typename SerializationPolicy>
+template <typename T_Contributions, typename T_Recv, typename T_Op>
+auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::allReduce(
+    T_Op op, const T_Contributions& contributions, T_Recv& recvData) -> void
+{
+    using value_type = typename T_Recv::value_type;
+
+    // Peers without hosted vertices do not take part
+    if (!graphContext.valid()) {
+        return;
+    }
+
+    Context context = graphContext;
+
+    // Reduce locally, starting with the data of the first vertex
+    auto contribution = std::begin(contributions);
+    assert(contribution != std::end(contributions));
+    std::vector<value_type> reduce(
+        contribution->second.data(), contribution->second.data() + contribution->second.size());
+
+    for (++contribution; contribution != std::end(contributions); ++contribution) {
+        assert(contribution->second.size() == reduce.size());
+        utils::elementwiseReduce(op, contribution->second.data(), reduce.data(), reduce.size());
+    }
+
+    decltype(auto) serialized = SerializationPolicy::serialize(reduce);
+    decltype(auto) skeleton = SerializationPolicy::prepare(recvData);
+    communicator->allReduce(context, op, serialized, skeleton);
+    SerializationPolicy::restore(recvData, skeleton);
+}
+
+template <typename T_CommunicationPolicy, typename T_GraphPolicy, typename SerializationPolicy>
+template <typename T_Contributions, typename T_Recv>
+auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::gather(
+    const Vertex& rootVertex,
+    const T_Contributions& contributions,
+    T_Recv& recvData,
+    const bool reorder) -> void
+{
+    using value_type = typename T_Recv::value_type;
+
+    // Peers without hosted vertices do not take part
+    if (!graphContext.valid()) {
+        return;
+    }
+
+    VAddr rootVAddr = locateVertex(rootVertex);
+    Context context = graphContext;
+
+    // Data of the hosted vertices in the order of the gather plan
+    std::vector<value_type> gather;
+    std::size_t vertex_i = 0;
+    for (auto const& contribution : contributions) {
+        assert(contribution.first.id == hostedVertices.at(vertex_i).id);
+        gather.insert(
+            gather.end(),
+            contribution.second.data(),
+            contribution.second.data() + contribution.second.size());
+        vertex_i++;
+    }
+    assert(vertex_i == hostedVertices.size());
+
+    std::vector<unsigned> recvCount;
+    if (reorder && rootVAddr == context.getVAddr()) {
+        std::vector<value_type> recvDataUnordered;
+        communicator->gatherVar(rootVAddr, context, gather, recvDataUnordered, recvCount);
+        recvData.resize(recvDataUnordered.size());
+        Cage::reorder(recvDataUnordered, recvCount, recvData);
+    } else {
+        communicator->gatherVar(rootVAddr, context, gather, recvData, recvCount);
+    }
+}
+
+template <typename T_CommunicationPolicy, typename T_GraphPolicy, typename SerializationPolicy>
+template <typename T_Contributions, typename T_Recv>
+auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::allGather(
+    const T_Contributions& contributions, T_Recv& recvData, const bool reorder) -> void
+{
+    using value_type = typename T_Recv::value_type;
+
+    // Peers without hosted vertices do not take part
+    if (!graphContext.valid()) {
+        return;
+    }
+
+    Context context = graphContext;
+
+    // Data of the hosted vertices in the order of the gather plan
+    std::vector<value_type> gather;
+    std::size_t vertex_i = 0;
+    for (auto const& contribution : contributions) {
+        assert(contribution.first.id == hostedVertices.at(vertex_i).id);
+        gather.insert(
+            gather.end(),
+            contribution.second.data(),
+            contribution.second.data() + contribution.second.size());
+        vertex_i++;
+    }
+    assert(vertex_i == hostedVertices.size());
+
+    std::vector<unsigned> recvCount;
+    if (reorder) {
+        std::vector<value_type> recvDataUnordered;
+        communicator->allGatherVar(context, gather, recvDataUnordered, recvCount);
+        recvData.resize(recvDataUnordered.size());
+        Cage::reorder(recvDataUnordered, recvCount, recvData);
+    } else {
+        communicator->allGatherVar(context, gather, recvData, recvCount);
     }
 }
 
@@ -1035,8 +1405,36 @@ auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::spread(
     const Vertex& vertex, const T& data, std::vector<Event>& events) -> void
 {
     std::vector<Edge> edges = getOutEdges(vertex);
+
+    // Edges grouped by the peer hosting their target
+    std::vector<std::pair<VAddr, Tag>> targets;
+    targets.reserve(edges.size());
     for (Edge edge : edges) {
-        Cage::send(edge, data, events);
+        targets.emplace_back(locateVertex(edge.target), edge.id);
+    }
+    std::sort(targets.begin(), targets.end());
+
+    // Serialized once, each event shares the read-only buffer and
+    // each peer receives it once for all of its edges
+    decltype(auto) serialized = SerializationPolicy::serialize(data);
+    std::vector<Tag> tags;
+    std::vector<CPEvent> cpEvents;
+    for (auto first = targets.begin(); first != targets.end();) {
+        auto last = std::find_if(first, targets.end(), [first](const std::pair<VAddr, Tag>& t) {
+            return t.first != first->first;
+        });
+
+        tags.clear();
+        for (auto it = first; it != last; ++it) {
+            tags.push_back(it->second);
+        }
+
+        cpEvents.clear();
+        communicator->asyncMulticast(first->first, tags, graphContext, serialized, cpEvents);
+        for (CPEvent& e : cpEvents) {
+            events.emplace_back(std::move(e), [kept = Kept<decltype(serialized)>(serialized)]() {});
+        }
+        first = last;
     }
 }
 
@@ -1045,9 +1443,11 @@ template <typename T>
 auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::spread(
     const Vertex& vertex, const T& data) -> void
 {
-    std::vector<Edge> edges = getOutEdges(vertex);
-    for (Edge edge : edges) {
-        Cage::send(edge, data);
+    std::vector<Event> events;
+    Cage::spread(vertex, data, events);
+    communicator->flush();
+    for (Event& event : events) {
+        event.wait();
     }
 }
 
@@ -1068,41 +1468,85 @@ auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::collect(
     }
 }
 
+template <typename T_CommunicationPolicy, typename T_GraphPolicy, typename SerializationPolicy>
+template <typename T_Send, typename T_Recv>
+auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::allToAll(
+    const T_Send& sendData, T_Recv& recvData) -> void
+{
+    communicator->allToAll(graphContext, sendData, recvData);
+}
+
+template <typename T_CommunicationPolicy, typename T_GraphPolicy, typename SerializationPolicy>
+template <typename T_Send, typename T_Recv>
+auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::allToAllVar(
+    const T_Send& sendData,
+    const std::vector<unsigned>& sendCount,
+    T_Recv& recvData,
+    std::vector<unsigned>& recvCount) -> void
+{
+    communicator->allToAllVar(graphContext, sendData, sendCount, recvData, recvCount);
+}
+
+template <typename T_CommunicationPolicy, typename T_GraphPolicy, typename SerializationPolicy>
+template <typename T_Send, typename T_Recv>
+auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::sparseExchange(
+    const std::map<VAddr, T_Send>& sendData, std::map<VAddr, T_Recv>& recvData) -> void
+{
+    communicator->sparseExchange(graphContext, sendData, recvData);
+}
+
+template <typename T_CommunicationPolicy, typename T_GraphPolicy, typename SerializationPolicy>
+template <typename T_Send, typename T_Recv, typename T_Op>
+auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::scan(
+    T_Op op, const T_Send& sendData, T_Recv& recvData) -> void
+{
+    communicator->scan(graphContext, op, sendData, recvData);
+}
+
+template <typename T_CommunicationPolicy, typename T_GraphPolicy, typename SerializationPolicy>
+template <typename T_Send, typename T_Recv, typename T_Op>
+auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::exscan(
+    T_Op op, const T_Send& sendData, T_Recv& recvData) -> void
+{
+    communicator->exscan(graphContext, op, sendData, recvData);
+}
+
 template <typename T_CommunicationPolicy, typename T_GraphPolicy, typename SerializationPolicy>
 auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::synchronize() -> void
 {
     communicator->synchronize(graphContext);
 }
 
+template <typename T_CommunicationPolicy, typename T_GraphPolicy, typename SerializationPolicy>
+auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::flush() -> void
+{
+    communicator->flush();
+}
+
 //!
 //! Utilities
 //!
 
 template <typename T_CommunicationPolicy, typename T_GraphPolicy, typename SerializationPolicy>
-template <class T>
+template <typename T_Data, typename T_Reordered>
 auto Cage<T_CommunicationPolicy, T_GraphPolicy, SerializationPolicy>::reorder(
-    const std::vector<T>& data,
+    const T_Data& data,
     const std::vector<unsigned>& recvCount,
-    std::vector<T>& dataReordered) -> void
+    T_Reordered& dataReordered) -> void
 {
-    std::vector<unsigned> prefixsum(graphContext.size(), 0);
-
-    utils::exclusivePrefixSum(recvCount.begin(), recvCount.end(), prefixsum.begin());
+    auto vertexID = gatherOrder.begin();
+    auto source = data.data();
 
     for (auto const& vAddr : graphContext) {
-        const std::vector<Vertex> hostedVertices = getVerticesHostedBy(vAddr);
-        const unsigned nElementsPerVertex
-            = recvCount.at(vAddr) / static_cast<unsigned>(hostedVertices.size());
-
-        for (unsigned hostVertex_i = 0; hostVertex_i < hostedVertices.size(); hostVertex_i++) {
-
-            unsigned sourceOffset = prefixsum[vAddr] + (hostVertex_i * nElementsPerVertex);
-            unsigned targetOffset = hostedVertices[hostVertex_i].id * nElementsPerVertex;
+        const unsigned nVertices = nVerticesOfPeer[vAddr];
+        const unsigned nElementsPerVertex = recvCount[vAddr] / nVertices;
 
+        for (unsigned vertex_i = 0; vertex_i < nVertices; ++vertex_i, ++vertexID) {
             std::copy(
-                data.begin() + sourceOffset,
-                data.begin() + sourceOffset + nElementsPerVertex,
-                dataReordered.begin() + targetOffset);
+                source,
+                source + nElementsPerVertex,
+                dataReordered.data() + (*vertexID * nElementsPerVertex));
+            source += nElementsPerVertex;
         }
     }
 }
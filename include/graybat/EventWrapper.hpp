@@ -20,7 +20,10 @@
 
 #pragma once
 
-#include <functional>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace graybat {
 
@@ -32,32 +35,82 @@ namespace graybat {
  * pointer which should exist until the user
  * remove the event.
  *
+ * The onReady callable is stored inside of the
+ * wrapper, thus wrapping an event does not
+ * allocate. It may hold up to four pointers.
+ *
  * @tparam T_Event Type that models graybat::concept::Event
- * @tparam T_Addtional Abitraty type (usually something with a shared ptr)
  */
 // models graybat::concept::Event
 template <typename T_Event> class EventWrapper {
     using Tag = unsigned;
     using VAddr = unsigned;
+    using Storage = typename std::aligned_storage<4 * sizeof(void*)>::type;
 
   public:
-    EventWrapper(T_Event event, std::function<void()> const& onReady)
-        : event(event)
-        , onReady(onReady)
+    template <typename T_OnReady>
+    EventWrapper(T_Event event, T_OnReady callable)
+        : event(std::move(event))
+        , ops(opsOf<T_OnReady>())
+    {
+        static_assert(
+            sizeof(T_OnReady) <= sizeof(Storage) && alignof(T_OnReady) <= alignof(Storage),
+            "onReady does not fit into the event wrapper.");
+        new (&onReady) T_OnReady(std::move(callable));
+    }
+
+    EventWrapper(EventWrapper const& other)
+        : event(other.event)
+        , ops(other.ops)
+    {
+        ops->copy(&other.onReady, &onReady);
+    }
+
+    EventWrapper(EventWrapper&& other) noexcept
+        : event(std::move(other.event))
+        , ops(other.ops)
+    {
+        ops->move(&other.onReady, &onReady);
+    }
+
+    EventWrapper& operator=(EventWrapper const& other)
+    {
+        if (this != &other) {
+            ops->destroy(&onReady);
+            event = other.event;
+            ops = other.ops;
+            ops->copy(&other.onReady, &onReady);
+        }
+        return *this;
+    }
+
+    EventWrapper& operator=(EventWrapper&& other) noexcept
+    {
+        if (this != &other) {
+            ops->destroy(&onReady);
+            event = std::move(other.event);
+            ops = other.ops;
+            ops->move(&other.onReady, &onReady);
+        }
+        return *this;
+    }
+
+    ~EventWrapper()
     {
+        ops->destroy(&onReady);
     }
 
     void wait()
     {
         event.wait();
-        onReady();
+        ops->call(&onReady);
     }
 
     bool ready()
     {
         auto isReady = event.ready();
         if (isReady) {
-            onReady();
+            ops->call(&onReady);
         }
         return isReady;
     }
@@ -73,7 +126,43 @@ template <typename T_Event> class EventWrapper {
     }
 
   private:
+    struct Ops {
+        void (*call)(void*);
+        void (*copy)(void const*, void*);
+        void (*move)(void*, void*);
+        void (*destroy)(void*);
+    };
+
+    template <typename T_OnReady> static void call(void* onReady)
+    {
+        (*static_cast<T_OnReady*>(onReady))();
+    }
+
+    template <typename T_OnReady> static void copy(void const* from, void* to)
+    {
+        new (to) T_OnReady(*static_cast<T_OnReady const*>(from));
+    }
+
+    template <typename T_OnReady> static void move(void* from, void* to)
+    {
+        new (to) T_OnReady(std::move(*static_cast<T_OnReady*>(from)));
+    }
+
+    template <typename T_OnReady> static void destroy(void* onReady)
+    {
+        static_cast<T_OnReady*>(onReady)->~T_OnReady();
+    }
+
+    template <typename T_OnReady> static Ops const* opsOf()
+    {
+        static const Ops ops{
+            &call<T_OnReady>, &copy<T_OnReady>, &move<T_OnReady>, &destroy<T_OnReady>
+        };
+        return &ops;
+    }
+
     T_Event event;
-    std::function<void()> onReady;
+    Ops const* ops;
+    Storage onReady;
 };
-}
\ No newline at end of file
+}
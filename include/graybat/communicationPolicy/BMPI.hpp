@@ -50,8 +50,24 @@ namespace mpi = boost::mpi;
 #include <graybat/communicationPolicy/bmpi/Context.hpp>
 #include <graybat/communicationPolicy/bmpi/Event.hpp>
 #include <graybat/communicationPolicy/bmpi/Status.hpp>
+#include <graybat/utils/elementwiseReduce.hpp>
 #include <graybat/utils/serialize_tuple.hpp>
 
+namespace boost {
+namespace mpi {
+
+// Reductions with utils::minimum and utils::maximum map to MPI_MIN and MPI_MAX
+template <typename T>
+struct is_mpi_op<utils::minimum<T>, T> : is_mpi_op<minimum<T>, T> {
+};
+
+template <typename T>
+struct is_mpi_op<utils::maximum<T>, T> : is_mpi_op<maximum<T>, T> {
+};
+
+} // namespace mpi
+} // namespace boost
+
 namespace graybat {
 
 namespace communicationPolicy {
@@ -174,8 +190,12 @@ struct BMPI : Base<BMPI> {
     asyncSend(const VAddr destVAddr, const Tag tag, const Context context, const T_Send& sendData)
     {
         Uri destUri = getVAddrUri(context, destVAddr);
-        mpi::request request = context.comm.isend(destUri, tag, sendData.data(), sendData.size());
-        return Event(request);
+        return isend(
+            destUri,
+            tag,
+            context,
+            sendData,
+            mpi::is_mpi_datatype<typename T_Send::value_type>());
     }
     /**
      * @brief Blocking receive of a message recvData from peer with virtual address srcVAddr.
@@ -230,8 +250,12 @@ struct BMPI : Base<BMPI> {
     Event asyncRecv(const VAddr srcVAddr, const Tag tag, const Context context, T_Recv& recvData)
     {
         Uri srcUri = getVAddrUri(context, srcVAddr);
-        mpi::request request = context.comm.irecv(srcUri, tag, recvData.data(), recvData.size());
-        return Event(request);
+        return irecv(
+            srcUri,
+            tag,
+            context,
+            recvData,
+            mpi::is_mpi_datatype<typename T_Recv::value_type>());
     }
 
     /** Test if message is available from peer with srcVAddr and particular tag
@@ -466,6 +490,138 @@ struct BMPI : Base<BMPI> {
         mpi::all_to_all(context.comm, sendData.data(), elementsPerPeer, recvData.data());
     }
 
+    /**
+     * @brief Distributes *sendData* of all peers in the *context* to all peers in the *context*
+     *        with **varying** chunk sizes. The first sendCount[0] elements of *sendData* are
+     *        sent to the peer with VAddr 0, the next sendCount[1] elements to the peer with
+     *        VAddr 1 and so on.
+     *
+     * @param[in]  context   Set of peers that exchange data
+     * @param[in]  sendData  Data that each peer wants to send
+     * @param[in]  sendCount Number of elements sent to each peer (can be zero)
+     * @param[out] recvData  Data from all peers, ordered by the VAddr of the sending peers.
+     *                       It will be resized to the total number of received elements.
+     * @param[out] recvCount Number of elements received from each peer
+     *
+     */
+    template <typename T_Send, typename T_Recv>
+    void allToAllVar(
+        const Context context,
+        const T_Send& sendData,
+        const std::vector<unsigned>& sendCount,
+        T_Recv& recvData,
+        std::vector<unsigned>& recvCount)
+    {
+        // Retrieve number of elements each peer sends
+        recvCount.resize(context.size());
+        allToAll(context, sendCount, recvCount);
+        recvData.resize(std::accumulate(recvCount.begin(), recvCount.end(), 0U));
+
+        std::vector<int> sdispls(context.size());
+        std::vector<int> rdispls(context.size());
+
+        // Create offset maps
+        unsigned sendOffset = 0;
+        unsigned recvOffset = 0;
+        for (unsigned i = 0; i < context.size(); ++i) {
+            sdispls[i] = sendOffset;
+            rdispls[i] = recvOffset;
+            sendOffset += sendCount[i];
+            recvOffset += recvCount[i];
+        }
+
+        // Exchange data with varying size
+        MPI_Alltoallv(
+            const_cast<typename T_Send::value_type*>(sendData.data()),
+            const_cast<int*>((int*)sendCount.data()),
+            sdispls.data(),
+            mpi::get_mpi_datatype<typename T_Send::value_type>(),
+            const_cast<typename T_Recv::value_type*>(recvData.data()),
+            const_cast<int*>((int*)recvCount.data()),
+            rdispls.data(),
+            mpi::get_mpi_datatype<typename T_Recv::value_type>(),
+            context.comm);
+    }
+
+    /**
+     * @brief Sparse dynamic data exchange: every peer sends data to a few other peers
+     *        without knowing from which peers it will receive data itself.
+     *
+     * NBX algorithm based on synchronous sends (MPI_Issend), probing for
+     * incoming messages and a nonblocking barrier (MPI_Ibarrier) that is
+     * entered once all own sends were matched by their receivers.
+     *
+     * @param[in]  context  Set of peers that exchange data
+     * @param[in]  sendData Maps the VAddr of destination peers to the data for this peer
+     * @param[out] recvData Maps the VAddr of the source peers to the received data.
+     *                      Peers that did not send data are not contained.
+     *
+     */
+    template <typename T_Send, typename T_Recv>
+    void sparseExchange(
+        const Context context,
+        const std::map<VAddr, T_Send>& sendData,
+        std::map<VAddr, T_Recv>& recvData)
+    {
+        using SendValueType = typename T_Send::value_type;
+        using RecvValueType = typename T_Recv::value_type;
+
+        const Tag tag = nextSparseExchangeTag(context);
+        MPI_Comm comm = context.comm;
+
+        recvData.clear();
+
+        std::vector<MPI_Request> sendRequests(sendData.size());
+        unsigned request_i = 0;
+        for (auto const& send : sendData) {
+            MPI_Issend(
+                const_cast<SendValueType*>(send.second.data()),
+                send.second.size(),
+                mpi::get_mpi_datatype<SendValueType>(),
+                getVAddrUri(context, send.first),
+                tag,
+                comm,
+                &sendRequests[request_i++]);
+        }
+
+        MPI_Request barrierRequest;
+        bool barrierEntered = false;
+        int done = 0;
+
+        while (!done) {
+            int available = 0;
+            MPI_Status status;
+            MPI_Iprobe(MPI_ANY_SOURCE, tag, comm, &available, &status);
+
+            if (available) {
+                int count = 0;
+                MPI_Get_count(&status, mpi::get_mpi_datatype<RecvValueType>(), &count);
+                T_Recv& data = recvData[status.MPI_SOURCE];
+                data.resize(count);
+                MPI_Recv(
+                    data.data(),
+                    count,
+                    mpi::get_mpi_datatype<RecvValueType>(),
+                    status.MPI_SOURCE,
+                    tag,
+                    comm,
+                    MPI_STATUS_IGNORE);
+            }
+
+            if (barrierEntered) {
+                MPI_Test(&barrierRequest, &done, MPI_STATUS_IGNORE);
+            } else {
+                int sent = 0;
+                MPI_Testall(
+                    sendRequests.size(), sendRequests.data(), &sent, MPI_STATUSES_IGNORE);
+                if (sent) {
+                    MPI_Ibarrier(comm, &barrierRequest);
+                    barrierEntered = true;
+                }
+            }
+        }
+    }
+
     /**
      * @brief Performs a reduction with a binary operator *op* on all *sendData* elements from all
      * peers
@@ -514,6 +670,47 @@ struct BMPI : Base<BMPI> {
         mpi::all_reduce(context.comm, sendData.data(), sendData.size(), recvData.data(), op);
     }
 
+    /**
+     * @brief Performs an inclusive prefix reduction (scan) with a binary operator *op*
+     *        on the *sendData* elements of the peers in the *context*. The peer with
+     *        VAddr i receives the reduction of the *sendData* of the peers 0,...,i.
+     *
+     * @param[in]  context   Set of peers that take part in the scan
+     * @param[in]  op        Associative binary operator that should be used for reduction
+     * @param[in]  sendData  Data that every peer contributes to the scan
+     * @param[out] recvData  Elementwise reduced data of all peers up to and including
+     *                       this peer. It has the same size as sendData.
+     *
+     */
+    template <typename T_Send, typename T_Recv, typename T_Op>
+    void scan(const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData)
+    {
+        mpi::scan(context.comm, sendData.data(), sendData.size(), recvData.data(), op);
+    }
+
+    /**
+     * @brief Performs an exclusive prefix reduction with a binary operator *op*
+     *        on the *sendData* elements of the peers in the *context*. The peer with
+     *        VAddr i receives the reduction of the *sendData* of the peers 0,...,i-1.
+     *        Maps to MPI_Exscan when *op* is a builtin MPI operation, otherwise the
+     *        generic implementation of the Base is used.
+     *
+     * @remark *recvData* of the peer with VAddr 0 is left unchanged.
+     *
+     * @param[in]  context   Set of peers that take part in the scan
+     * @param[in]  op        Associative binary operator that should be used for reduction
+     * @param[in]  sendData  Data that every peer contributes to the scan
+     * @param[out] recvData  Elementwise reduced data of all peers with lower VAddr.
+     *                       It has the same size as sendData.
+     *
+     */
+    template <typename T_Send, typename T_Recv, typename T_Op>
+    void exscan(const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData)
+    {
+        using RecvValueType = typename T_Recv::value_type;
+        exscan(context, op, sendData, recvData, mpi::is_mpi_op<T_Op, RecvValueType>());
+    }
+
     /**
      * @brief Send *sendData* from peer *rootVAddr* to all peers in *context*.
      *        Every peer will receive the same data.
@@ -611,6 +808,35 @@ struct BMPI : Base<BMPI> {
     /** @} */
 
   private:
+    template <typename T_Send, typename T_Recv, typename T_Op>
+    void exscan(
+        const Context context,
+        T_Op,
+        const T_Send& sendData,
+        T_Recv& recvData,
+        boost::mpl::true_)
+    {
+        using RecvValueType = typename T_Recv::value_type;
+        MPI_Exscan(
+            const_cast<typename T_Send::value_type*>(sendData.data()),
+            recvData.data(),
+            sendData.size(),
+            mpi::get_mpi_datatype<RecvValueType>(*(recvData.data())),
+            mpi::is_mpi_op<T_Op, RecvValueType>::op(),
+            context.comm);
+    }
+
+    template <typename T_Send, typename T_Recv, typename T_Op>
+    void exscan(
+        const Context context,
+        T_Op op,
+        const T_Send& sendData,
+        T_Recv& recvData,
+        boost::mpl::false_)
+    {
+        Base<BMPI>::exscan(context, op, sendData, recvData);
+    }
+
     /***************************************************************************
      *
      * @name Private Member
@@ -632,6 +858,65 @@ struct BMPI : Base<BMPI> {
         std::cout << "[" << vAddr << "] " << msg;
     }
 
+    /**
+     * @brief Non blocking send and receive, MPI datatypes go
+     *        straight to MPI, thus without the allocations of
+     *        a boost::mpi::request.
+     */
+    template <typename T_Send>
+    Event isend(
+        const Uri destUri,
+        const Tag tag,
+        const Context& context,
+        const T_Send& sendData,
+        boost::mpl::true_)
+    {
+        MPI_Request request;
+        MPI_Isend(
+            sendData.data(),
+            sendData.size(),
+            mpi::get_mpi_datatype<typename T_Send::value_type>(),
+            destUri,
+            tag,
+            MPI_Comm(context.comm),
+            &request);
+        return Event(request);
+    }
+
+    template <typename T_Send>
+    Event isend(
+        const Uri destUri,
+        const Tag tag,
+        const Context& context,
+        const T_Send& sendData,
+        boost::mpl::false_)
+    {
+        return Event(context.comm.isend(destUri, tag, sendData.data(), sendData.size()));
+    }
+
+    template <typename T_Recv>
+    Event irecv(
+        const Uri srcUri, const Tag tag, const Context& context, T_Recv& recvData, boost::mpl::true_)
+    {
+        MPI_Request request;
+        MPI_Irecv(
+            recvData.data(),
+            recvData.size(),
+            mpi::get_mpi_datatype<typename T_Recv::value_type>(),
+            srcUri,
+            tag,
+            MPI_Comm(context.comm),
+            &request);
+        return Event(request);
+    }
+
+    template <typename T_Recv>
+    Event irecv(
+        const Uri srcUri, const Tag tag, const Context& context, T_Recv& recvData, boost::mpl::false_)
+    {
+        return Event(context.comm.irecv(srcUri, tag, recvData.data(), recvData.size()));
+    }
+
     /**
      * @brief Returns the uri of a vAddr in a
      *        specific context.
@@ -20,7 +20,16 @@
 
 #pragma once
 
+// Stl
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+#include <numeric>
+#include <vector>
+
 #include <graybat/communicationPolicy/Traits.hpp>
+#include <graybat/utils/elementwiseReduce.hpp>
 
 namespace graybat {
 
@@ -32,9 +41,21 @@ template <typename T_CommunicationPolicy> struct Base {
     using VAddr = typename graybat::communicationPolicy::VAddr<CommunicationPolicy>;
     using Tag = typename graybat::communicationPolicy::Tag<CommunicationPolicy>;
     using Context = typename graybat::communicationPolicy::Context<CommunicationPolicy>;
+    using ContextID = typename graybat::communicationPolicy::ContextID<CommunicationPolicy>;
     using Event = typename graybat::communicationPolicy::Event<CommunicationPolicy>;
     using Status = typename graybat::communicationPolicy::Status<CommunicationPolicy>;
 
+    /**
+     * Tags reserved for sparseExchange. They are below the tag upper bound
+     * every MPI implementation has to support (32767). Two data tags are
+     * alternated between consecutive exchanges on the same context, thus
+     * messages of a peer that already left an exchange can not be mixed up
+     * with messages of the exchange that is still running on other peers.
+     */
+    static constexpr unsigned sparseExchangeDataTag = 32763;
+    static constexpr unsigned sparseExchangeBarrierTag = 32765;
+    static constexpr unsigned sparseExchangeReleaseTag = 32766;
+
     /***********************************************************************
      * Interface
      ***********************************************************************/
@@ -87,6 +108,35 @@ template <typename T_CommunicationPolicy> struct Base {
     boost::optional<Status> asyncProbe(const VAddr srcVAddr, const Tag tag, const Context context)
         = delete;
 
+    /**
+     * @brief Sends all messages the communication policy holds
+     *        back to batch them. Nothing is held back by default.
+     */
+    void flush()
+    {
+    }
+
+    /**
+     * @brief Non blocking transmission of the same *sendData* with
+     *        each of *tags* to the peer with virtual address
+     *        *destVAddr*. An event per tag is appended to *events*.
+     *
+     *        Sends once per tag by default, policies may transmit
+     *        the data once and fan it out on the receiving peer.
+     */
+    template <typename T_Send>
+    void asyncMulticast(
+        const VAddr destVAddr,
+        const std::vector<Tag>& tags,
+        const Context context,
+        const T_Send& sendData,
+        std::vector<Event>& events)
+    {
+        for (Tag const tag : tags) {
+            events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(
+                destVAddr, tag, context, sendData));
+        }
+    }
 
     /** @} */
 
@@ -202,6 +252,63 @@ template <typename T_CommunicationPolicy> struct Base {
     template <typename T_Send, typename T_Recv>
     void allScatter(const Context context, const T_Send& sendData, T_Recv& recvData);
 
+    /**
+     * @brief Distributes *sendData* of all peers in the *context* to all peers in the *context*.
+     *        *sendData* is divided into context.size() chunks of equal size, the ith chunk
+     *        is sent to the peer with VAddr i.
+     *
+     * @param[in]  context  Set of peers that exchange data
+     * @param[in]  sendData Data that each peer wants to send, one chunk for each peer
+     * @param[out] recvData Data from all peers, the chunks are ordered by the VAddr of the
+     *                      sending peers. Needs to have the same size as *sendData*.
+     *
+     */
+    template <typename T_Send, typename T_Recv>
+    void allToAll(const Context context, const T_Send& sendData, T_Recv& recvData);
+
+    /**
+     * @brief Distributes *sendData* of all peers in the *context* to all peers in the *context*
+     *        with **varying** chunk sizes. The first sendCount[0] elements of *sendData* are
+     *        sent to the peer with VAddr 0, the next sendCount[1] elements to the peer with
+     *        VAddr 1 and so on.
+     *
+     * @param[in]  context   Set of peers that exchange data
+     * @param[in]  sendData  Data that each peer wants to send
+     * @param[in]  sendCount Number of elements sent to each peer (can be zero)
+     * @param[out] recvData  Data from all peers, ordered by the VAddr of the sending peers.
+     *                       It will be resized to the total number of received elements.
+     * @param[out] recvCount Number of elements received from each peer
+     *
+     */
+    template <typename T_Send, typename T_Recv>
+    void allToAllVar(
+        const Context context,
+        const T_Send& sendData,
+        const std::vector<unsigned>& sendCount,
+        T_Recv& recvData,
+        std::vector<unsigned>& recvCount);
+
+    /**
+     * @brief Sparse dynamic data exchange: every peer sends data to a few other peers
+     *        without knowing from which peers it will receive data itself.
+     *
+     * Implements the NBX algorithm (nonblocking consensus): data is sent
+     * asynchronously while incoming messages are probed. Once all own sends
+     * are completed a peer enters a nonblocking barrier, but keeps on probing
+     * until the barrier is passed by all peers of the *context*.
+     *
+     * @param[in]  context  Set of peers that exchange data
+     * @param[in]  sendData Maps the VAddr of destination peers to the data for this peer
+     * @param[out] recvData Maps the VAddr of the source peers to the received data.
+     *                      Peers that did not send data are not contained.
+     *
+     */
+    template <typename T_Send, typename T_Recv>
+    void sparseExchange(
+        const Context context,
+        const std::map<VAddr, T_Send>& sendData,
+        std::map<VAddr, T_Recv>& recvData);
+
     /**
      * @brief Performs a reduction with a binary operator *op* on all *sendData* elements from all
      * peers
@@ -243,6 +350,41 @@ template <typename T_CommunicationPolicy> struct Base {
     template <typename T_Send, typename T_Recv, typename T_Op>
     void allReduce(const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData);
 
+    /**
+     * @brief Performs an inclusive prefix reduction (scan) with a binary operator *op*
+     *        on the *sendData* elements of the peers in the *context*. The peer with
+     *        VAddr i receives the reduction of the *sendData* of the peers 0,...,i.
+     *        Uses recursive doubling, thus it needs log(context.size()) steps.
+     *
+     * @param[in]  context   Set of peers that take part in the scan
+     * @param[in]  op        Associative binary operator that should be used for reduction
+     * @param[in]  sendData  Data that every peer contributes to the scan
+     * @param[out] recvData  Elementwise reduced data of all peers up to and including
+     *                       this peer. It has the same size as sendData.
+     *
+     */
+    template <typename T_Send, typename T_Recv, typename T_Op>
+    void scan(const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData);
+
+    /**
+     * @brief Performs an exclusive prefix reduction with a binary operator *op*
+     *        on the *sendData* elements of the peers in the *context*. The peer with
+     *        VAddr i receives the reduction of the *sendData* of the peers 0,...,i-1.
+     *        Uses recursive doubling, thus it needs log(context.size()) steps.
+     *
+     * @remark *recvData* of the peer with VAddr 0 is left unchanged, since there is no
+     *         identity element known for an arbitrary *op*.
+     *
+     * @param[in]  context   Set of peers that take part in the scan
+     * @param[in]  op        Associative binary operator that should be used for reduction
+     * @param[in]  sendData  Data that every peer contributes to the scan
+     * @param[out] recvData  Elementwise reduced data of all peers with lower VAddr.
+     *                       It has the same size as sendData.
+     *
+     */
+    template <typename T_Send, typename T_Recv, typename T_Op>
+    void exscan(const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData);
+
     /**
      * @brief Send *sendData* from peer *rootVAddr* to all peers in *context*.
      *        Every peer will receive the same data.
@@ -285,6 +427,26 @@ template <typename T_CommunicationPolicy> struct Base {
     Context getGlobalContext() = delete;
 
     /** @} */
+
+  protected:
+    /**
+     * @brief Returns the data tag of the next sparseExchange on *context*.
+     */
+    Tag nextSparseExchangeTag(const Context context);
+
+    /**
+     * @brief Recursive doubling prefix reduction used by scan() and exscan().
+     */
+    template <typename T_Send, typename T_Recv, typename T_Op>
+    void scanImpl(
+        const Context context,
+        T_Op op,
+        const T_Send& sendData,
+        T_Recv& recvData,
+        const bool exclusive);
+
+  private:
+    std::map<ContextID, unsigned> sparseExchangeCount;
 };
 
 /***********************************************************************
@@ -373,9 +535,8 @@ void Base<T_CommunicationPolicy>::allGather(
             recvData.data() + recvOffset, tmpData.data(), tmpData.size() * sizeof(RecvValueType));
     }
 
-    for (unsigned i = 0; i < events.size(); ++i) {
-        events.back().wait();
-        events.pop_back();
+    for (Event& e : events) {
+        e.wait();
     }
 }
 
@@ -412,9 +573,8 @@ void Base<T_CommunicationPolicy>::allGatherVar(
         recvOffset += recvCount.at(vAddr);
     }
 
-    for (unsigned i = 0; i < events.size(); ++i) {
-        events.back().wait();
-        events.pop_back();
+    for (Event& e : events) {
+        e.wait();
     }
 }
 
@@ -429,21 +589,24 @@ void Base<T_CommunicationPolicy>::scatter(
 
     std::vector<Event> events;
 
+    // Send buffers live until their events completed
+    std::vector<std::vector<SendValueType>> sendBuffers;
+
     if (rootVAddr == context.getVAddr()) {
+        sendBuffers.reserve(context.size());
         for (auto const& vAddr : context) {
             size_t sendOffset = vAddr * recvData.size();
-            std::vector<SendValueType> tmpData(
+            sendBuffers.emplace_back(
                 sendData.begin() + sendOffset, sendData.begin() + sendOffset + recvData.size());
-            events.push_back(
-                static_cast<CommunicationPolicy*>(this)->asyncSend(vAddr, 0, context, tmpData));
+            events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(
+                vAddr, 0, context, sendBuffers.back()));
         }
     }
 
     static_cast<CommunicationPolicy*>(this)->recv(rootVAddr, 0, context, recvData);
 
-    for (unsigned i = 0; i < events.size(); ++i) {
-        events.back().wait();
-        events.pop_back();
+    for (Event& e : events) {
+        e.wait();
     }
 }
 
@@ -459,12 +622,15 @@ void Base<T_CommunicationPolicy>::allScatter(
     std::vector<Event> events;
     size_t nElementsPerPeer = static_cast<size_t>(recvData.size() / context.size());
 
+    // Send buffers live until their events completed
+    std::vector<std::vector<SendValueType>> sendBuffers;
+    sendBuffers.reserve(context.size());
     for (auto const& vAddr : context) {
         size_t sendOffset = vAddr * nElementsPerPeer;
-        std::vector<SendValueType> tmpData(
+        sendBuffers.emplace_back(
             sendData.begin() + sendOffset, sendData.begin() + sendOffset + nElementsPerPeer);
-        events.push_back(
-            static_cast<CommunicationPolicy*>(this)->asyncSend(vAddr, 0, context, tmpData));
+        events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(
+            vAddr, 0, context, sendBuffers.back()));
     }
 
     for (auto const& vAddr : context) {
@@ -475,12 +641,197 @@ void Base<T_CommunicationPolicy>::allScatter(
             recvData.data() + recvOffset, tmpData.data(), tmpData.size() * sizeof(SendValueType));
     }
 
-    for (unsigned i = 0; i < events.size(); ++i) {
-        events.back().wait();
-        events.pop_back();
+    for (Event& e : events) {
+        e.wait();
+    }
+}
+
+template <typename T_CommunicationPolicy>
+template <typename T_Send, typename T_Recv>
+void Base<T_CommunicationPolicy>::allToAll(
+    const Context context, const T_Send& sendData, T_Recv& recvData)
+{
+    using SendValueType = typename T_Send::value_type;
+    using RecvValueType = typename T_Recv::value_type;
+    using CommunicationPolicy = T_CommunicationPolicy;
+    using Event = Base<CommunicationPolicy>::Event;
+
+    std::vector<Event> events;
+    std::vector<std::vector<SendValueType>> sendChunks;
+    size_t nElementsPerPeer = static_cast<size_t>(sendData.size() / context.size());
+
+    sendChunks.reserve(context.size());
+    for (auto const& vAddr : context) {
+        size_t sendOffset = vAddr * nElementsPerPeer;
+        sendChunks.emplace_back(
+            sendData.begin() + sendOffset, sendData.begin() + sendOffset + nElementsPerPeer);
+        events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(
+            vAddr, 0, context, sendChunks.back()));
+    }
+
+    std::vector<RecvValueType> tmpData(nElementsPerPeer);
+    for (auto const& vAddr : context) {
+        size_t recvOffset = vAddr * nElementsPerPeer;
+        static_cast<CommunicationPolicy*>(this)->recv(vAddr, 0, context, tmpData);
+        std::memcpy(
+            recvData.data() + recvOffset, tmpData.data(), tmpData.size() * sizeof(RecvValueType));
+    }
+
+    for (Event& e : events) {
+        e.wait();
+    }
+}
+
+template <typename T_CommunicationPolicy>
+template <typename T_Send, typename T_Recv>
+void Base<T_CommunicationPolicy>::allToAllVar(
+    const Context context,
+    const T_Send& sendData,
+    const std::vector<unsigned>& sendCount,
+    T_Recv& recvData,
+    std::vector<unsigned>& recvCount)
+{
+    using SendValueType = typename T_Send::value_type;
+    using RecvValueType = typename T_Recv::value_type;
+    using CommunicationPolicy = T_CommunicationPolicy;
+    using Event = Base<CommunicationPolicy>::Event;
+
+    // Retrieve number of elements each peer sends
+    recvCount.resize(context.size());
+    static_cast<CommunicationPolicy*>(this)->allToAll(context, sendCount, recvCount);
+    recvData.resize(std::accumulate(recvCount.begin(), recvCount.end(), 0U));
+
+    std::vector<Event> events;
+    std::vector<std::vector<SendValueType>> sendChunks;
+    sendChunks.reserve(context.size());
+
+    size_t sendOffset = 0;
+    for (auto const& vAddr : context) {
+        sendChunks.emplace_back(
+            sendData.begin() + sendOffset, sendData.begin() + sendOffset + sendCount.at(vAddr));
+        events.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(
+            vAddr, 0, context, sendChunks.back()));
+        sendOffset += sendCount.at(vAddr);
+    }
+
+    size_t recvOffset = 0;
+    for (auto const& vAddr : context) {
+        std::vector<RecvValueType> tmpData(recvCount.at(vAddr));
+        static_cast<CommunicationPolicy*>(this)->recv(vAddr, 0, context, tmpData);
+        std::memcpy(
+            recvData.data() + recvOffset, tmpData.data(), tmpData.size() * sizeof(RecvValueType));
+        recvOffset += recvCount.at(vAddr);
+    }
+
+    for (Event& e : events) {
+        e.wait();
     }
 }
 
+template <typename T_CommunicationPolicy>
+template <typename T_Send, typename T_Recv>
+void Base<T_CommunicationPolicy>::sparseExchange(
+    const Context context,
+    const std::map<VAddr, T_Send>& sendData,
+    std::map<VAddr, T_Recv>& recvData)
+{
+    using RecvValueType = typename T_Recv::value_type;
+    using CommunicationPolicy = T_CommunicationPolicy;
+    using Event = Base<CommunicationPolicy>::Event;
+
+    const Tag tag = nextSparseExchangeTag(context);
+    const VAddr rootVAddr = 0;
+    std::array<char, 0> null;
+
+    std::vector<Event> sendEvents;
+    std::vector<Event> barrierEvents;
+    std::vector<bool> arrived(context.size(), false);
+    unsigned nArrived = 0;
+    bool barrierEntered = false;
+    bool released = false;
+
+    recvData.clear();
+
+    for (auto const& send : sendData) {
+        sendEvents.push_back(
+            static_cast<CommunicationPolicy*>(this)->asyncSend(send.first, tag, context, send.second));
+    }
+
+    // Receives all messages that are available so far
+    auto recvAvailable = [&]() {
+        for (auto const& vAddr : context) {
+            auto status = static_cast<CommunicationPolicy*>(this)->asyncProbe(vAddr, tag, context);
+            if (status) {
+                T_Recv& data = recvData[vAddr];
+                data.resize(status->template size<RecvValueType>());
+                static_cast<CommunicationPolicy*>(this)->recv(vAddr, tag, context, data);
+            }
+        }
+    };
+
+    while (!released) {
+        recvAvailable();
+
+        // Enter the barrier as soon as all own messages were delivered
+        if (!barrierEntered) {
+            sendEvents.erase(
+                std::remove_if(
+                    sendEvents.begin(), sendEvents.end(), [](Event& e) { return e.ready(); }),
+                sendEvents.end());
+
+            if (sendEvents.empty()) {
+                barrierEvents.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(
+                    rootVAddr, sparseExchangeBarrierTag, context, null));
+                barrierEntered = true;
+            }
+        }
+
+        if (barrierEntered) {
+            // Root releases all peers once every peer entered the barrier
+            if (context.getVAddr() == rootVAddr && nArrived < context.size()) {
+                for (auto const& vAddr : context) {
+                    if (!arrived[vAddr]
+                        && static_cast<CommunicationPolicy*>(this)->asyncProbe(
+                               vAddr, sparseExchangeBarrierTag, context)) {
+                        static_cast<CommunicationPolicy*>(this)->recv(
+                            vAddr, sparseExchangeBarrierTag, context, null);
+                        arrived[vAddr] = true;
+                        nArrived++;
+                    }
+                }
+
+                if (nArrived == context.size()) {
+                    for (auto const& vAddr : context) {
+                        barrierEvents.push_back(static_cast<CommunicationPolicy*>(this)->asyncSend(
+                            vAddr, sparseExchangeReleaseTag, context, null));
+                    }
+                }
+            }
+
+            if (static_cast<CommunicationPolicy*>(this)->asyncProbe(
+                    rootVAddr, sparseExchangeReleaseTag, context)) {
+                static_cast<CommunicationPolicy*>(this)->recv(
+                    rootVAddr, sparseExchangeReleaseTag, context, null);
+                released = true;
+            }
+        }
+    }
+
+    // Messages that arrived after the last receive above, all of them
+    // were delivered before the release was sent
+    recvAvailable();
+
+    for (Event& e : barrierEvents) {
+        e.wait();
+    }
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::nextSparseExchangeTag(const Context context) -> Tag
+{
+    return sparseExchangeDataTag + (sparseExchangeCount[context.getID()]++ % 2);
+}
+
 template <typename T_CommunicationPolicy>
 template <typename T_Send, typename T_Recv, typename T_Op>
 void Base<T_CommunicationPolicy>::reduce(
@@ -501,9 +852,7 @@ void Base<T_CommunicationPolicy>::reduce(
             std::vector<RecvValueType> tmpData(recvData.size());
             static_cast<CommunicationPolicy*>(this)->recv(vAddr, 0, context, tmpData);
 
-            for (size_t i = 0; i < recvData.size(); ++i) {
-                recvData.data()[i] = op(recvData.data()[i], tmpData[i]);
-            }
+            utils::elementwiseReduce(op, tmpData.data(), recvData.data(), recvData.size());
         }
     }
 
@@ -521,21 +870,100 @@ void Base<T_CommunicationPolicy>::allReduce(
 
     std::vector<Event> events;
     for (auto const& vAddr : context) {
-        Event e = static_cast<CommunicationPolicy*>(this)->asyncSend(vAddr, 0, context, sendData);
+        events.push_back(
+            static_cast<CommunicationPolicy*>(this)->asyncSend(vAddr, 0, context, sendData));
     }
 
     for (auto const& vAddr : context) {
         std::vector<RecvValueType> tmpData(recvData.size());
         static_cast<CommunicationPolicy*>(this)->recv(vAddr, 0, context, tmpData);
 
-        for (size_t i = 0; i < recvData.size(); ++i) {
-            recvData.data()[i] = op(recvData.data()[i], tmpData[i]);
-        }
+        utils::elementwiseReduce(op, tmpData.data(), recvData.data(), recvData.size());
+    }
+
+    for (Event& e : events) {
+        e.wait();
+    }
+}
+
+template <typename T_CommunicationPolicy>
+template <typename T_Send, typename T_Recv, typename T_Op>
+void Base<T_CommunicationPolicy>::scan(
+    const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData)
+{
+    scanImpl(context, op, sendData, recvData, false);
+}
+
+template <typename T_CommunicationPolicy>
+template <typename T_Send, typename T_Recv, typename T_Op>
+void Base<T_CommunicationPolicy>::exscan(
+    const Context context, T_Op op, const T_Send& sendData, T_Recv& recvData)
+{
+    scanImpl(context, op, sendData, recvData, true);
+}
+
+template <typename T_CommunicationPolicy>
+template <typename T_Send, typename T_Recv, typename T_Op>
+void Base<T_CommunicationPolicy>::scanImpl(
+    const Context context,
+    T_Op op,
+    const T_Send& sendData,
+    T_Recv& recvData,
+    const bool exclusive)
+{
+    using RecvValueType = typename T_Recv::value_type;
+    using CommunicationPolicy = T_CommunicationPolicy;
+    using Event = Base<CommunicationPolicy>::Event;
+
+    const VAddr vAddr = context.getVAddr();
+    const size_t nPeers = context.size();
+
+    // Reduction of all data received so far including the own sendData,
+    // this is what the peer forwards in each step.
+    std::vector<RecvValueType> partial(sendData.begin(), sendData.end());
+    std::vector<RecvValueType> sendBuffer(partial.size());
+    std::vector<RecvValueType> tmpData(partial.size());
+    bool hasResult = false;
+
+    if (!exclusive) {
+        std::copy(sendData.begin(), sendData.end(), recvData.begin());
     }
 
-    for (unsigned i = 0; i < events.size(); ++i) {
-        events.back().wait();
-        events.pop_back();
+    for (size_t distance = 1; distance < nPeers; distance *= 2) {
+        std::copy(partial.begin(), partial.end(), sendBuffer.begin());
+
+        bool sending = vAddr + distance < nPeers;
+        bool receiving = vAddr >= distance;
+
+        if (sending) {
+            Event e = static_cast<CommunicationPolicy*>(this)->asyncSend(
+                vAddr + distance, 0, context, sendBuffer);
+
+            if (receiving) {
+                static_cast<CommunicationPolicy*>(this)->recv(
+                    vAddr - distance, 0, context, tmpData);
+            }
+            e.wait();
+
+        } else if (receiving) {
+            static_cast<CommunicationPolicy*>(this)->recv(vAddr - distance, 0, context, tmpData);
+        }
+
+        // Data of peers with lower VAddr is always the left operand
+        if (receiving) {
+            for (size_t i = 0; i < partial.size(); ++i) {
+                partial[i] = op(tmpData[i], partial[i]);
+            }
+
+            if (exclusive && !hasResult) {
+                std::copy(tmpData.begin(), tmpData.end(), recvData.begin());
+            } else {
+                for (size_t i = 0; i < partial.size(); ++i) {
+                    recvData.data()[i] = op(tmpData[i], recvData.data()[i]);
+                }
+            }
+            hasResult = true;
+        }
     }
 }
 
@@ -550,15 +978,15 @@ void Base<T_CommunicationPolicy>::broadcast(
 
     if (rootVAddr == context.getVAddr()) {
         for (auto const& vAddr : context) {
-            static_cast<CommunicationPolicy*>(this)->asyncSend(vAddr, 0, context, data);
+            events.push_back(
+                static_cast<CommunicationPolicy*>(this)->asyncSend(vAddr, 0, context, data));
         }
     }
 
     static_cast<CommunicationPolicy*>(this)->recv(rootVAddr, 0, context, data);
 
-    for (unsigned i = 0; i < events.size(); ++i) {
-        events.back().wait();
-        events.pop_back();
+    for (Event& e : events) {
+        e.wait();
     }
 }
 
@@ -0,0 +1,270 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Stl
+#include <chrono>
+#include <memory>
+#include <string>
+#include <system_error>
+
+// GrayBat
+#include <graybat/communicationPolicy/Traits.hpp>
+#include <graybat/communicationPolicy/socket/Base.hpp> /* Base */
+#include <graybat/communicationPolicy/tcp/Config.hpp> /* Config */
+#include <graybat/communicationPolicy/tcp/Message.hpp> /* Message */
+#include <graybat/communicationPolicy/tcp/SendQueue.hpp> /* SendQueue */
+#include <graybat/communicationPolicy/tcp/Socket.hpp> /* Socket */
+#include <graybat/communicationPolicy/zmq/Context.hpp> /* Context */
+#include <graybat/communicationPolicy/zmq/Event.hpp> /* Event */
+#include <graybat/communicationPolicy/zmq/Status.hpp> /* Status */
+
+namespace graybat {
+namespace communicationPolicy {
+
+/************************************************************************/ /**
+  * @class TCP
+  *
+  * @brief Implementation of the Cage communicationPolicy interface
+  *        based on plain TCP sockets.
+  *
+  * Each peer listens on a data and a ctrl socket and connects a
+  * stream to each peer it sends to. Frames are sent by the calling
+  * thread with a single sendmsg, which gathers the payload right
+  * from the user data unless the message is batched. The receive
+  * threads of socket::Base wait for all incoming streams in an epoll
+  * event loop. Thus no I/O threads are involved. Context, event and
+  * status are shared with the ZMQ policy.
+  *
+  * With Config::ioUring the receive threads wait in an io_uring and
+  * the batches sent together, by a flush or by the batch timeout,
+  * are submitted at once. A flush of the batches to all neighbours
+  * thus costs a single system call. Kernels without multishot
+  * receives, before Linux 6.0, receive by epoll nonetheless.
+  *
+  ***************************************************************************/
+struct TCP;
+
+namespace traits {
+
+template <> struct ContextType<TCP> {
+    using type = graybat::communicationPolicy::zmq::Context<TCP>;
+};
+
+template <> struct ContextIDType<TCP> {
+    using type = unsigned;
+};
+
+template <> struct EventType<TCP> {
+    using type = graybat::communicationPolicy::zmq::Event<TCP>;
+};
+
+template <> struct StatusType<TCP> {
+    using type = graybat::communicationPolicy::zmq::Status<TCP>;
+};
+
+template <> struct ConfigType<TCP> {
+    using type = graybat::communicationPolicy::tcp::Config;
+};
+}
+
+namespace socket {
+namespace traits {
+
+template <> struct UriType<TCP> {
+    using type = std::string;
+};
+
+template <> struct SocketType<TCP> {
+    using type = graybat::communicationPolicy::tcp::Socket;
+};
+
+template <> struct MessageType<TCP> {
+    using type = graybat::communicationPolicy::tcp::Message<TCP>;
+};
+}
+}
+
+struct TCP : public graybat::communicationPolicy::socket::Base<TCP> {
+
+    // Sends a flush submits at once at most
+    static constexpr unsigned sendQueueCapacity = 64;
+
+    // Type defs
+    using Tag = graybat::communicationPolicy::Tag<TCP>;
+    using ContextID = graybat::communicationPolicy::ContextID<TCP>;
+    using MsgID = graybat::communicationPolicy::MsgID<TCP>;
+    using VAddr = graybat::communicationPolicy::VAddr<TCP>;
+    using Context = graybat::communicationPolicy::Context<TCP>;
+    using Event = graybat::communicationPolicy::Event<TCP>;
+    using Config = graybat::communicationPolicy::Config<TCP>;
+    using MsgType = graybat::communicationPolicy::MsgType<TCP>;
+    using Uri = graybat::communicationPolicy::socket::Uri<TCP>;
+    using Socket = graybat::communicationPolicy::socket::Socket<TCP>;
+    using Message = graybat::communicationPolicy::socket::Message<TCP>;
+    using SocketBase = graybat::communicationPolicy::socket::Base<TCP>;
+    template <typename T_Socket>
+    using SocketPool = graybat::communicationPolicy::socket::SocketPool<T_Socket>;
+
+    // Sockets
+    Socket recvSocket;
+    Socket ctrlSocket;
+    SocketPool<Socket> sendSockets;
+    SocketPool<Socket> ctrlSendSockets;
+    SocketPool<Socket> railSendSockets;
+
+    const std::chrono::milliseconds connectTimeout;
+
+    // Batches sent by a flush, when Config::ioUring is set. Guarded
+    // by sendMtx.
+    std::unique_ptr<tcp::SendQueue> sendQueue;
+    bool deferSends;
+
+    // Uri
+    const Uri peerUri;
+    const Uri ctrlUri;
+
+    // Construct
+    TCP(Config const config)
+        : SocketBase(config)
+        , recvSocket(config.ioUring)
+        , ctrlSocket(config.ioUring)
+        , sendSockets(config.maxSendSockets)
+        , ctrlSendSockets(config.maxSendSockets)
+        , railSendSockets(config.maxSendSockets * (std::max<size_t>(config.nRails, 1) - 1))
+        , connectTimeout(config.connectTimeoutMs)
+        , sendQueue(config.ioUring ? new tcp::SendQueue(sendQueueCapacity) : nullptr)
+        , deferSends(false)
+        , peerUri(bindToNextFreePort(recvSocket, config.peerUri))
+        , ctrlUri(bindToNextFreePort(ctrlSocket, config.peerUri))
+    {
+        SocketBase::init();
+    }
+
+    // Copy constructor
+    TCP(TCP&) = delete;
+    // Copy assignment constructor
+    TCP& operator=(TCP&) = delete;
+    // Move constructor
+    TCP(TCP&& other) = delete;
+    // Move assignment constructor
+    TCP& operator=(TCP&&) = delete;
+
+    // Destructor
+    ~TCP()
+    {
+        SocketBase::deinit();
+    }
+
+    /***********************************************************************/ /**
+      *
+      * @name Socket base utilities
+      *
+      * @{
+      *
+      ***************************************************************************/
+
+    template <typename T_Socket> void connectToSocket(T_Socket& socket, std::string const uri)
+    {
+        socket.connect(uri, connectTimeout);
+    }
+
+    template <typename T_Socket> void bindToSocket(T_Socket& socket, std::string const uri)
+    {
+        socket.bind(uri);
+    }
+
+    template <typename T_Socket> void unbindFromSocket(T_Socket& socket, std::string const uri)
+    {
+        socket.unbind(uri);
+    }
+
+    Socket createSendSocket()
+    {
+        return Socket();
+    }
+
+    template <typename T_Socket> void recvFromSocket(T_Socket& socket, Message& message)
+    {
+        socket.recv(message.getMessage());
+        message.decodeHeader();
+    }
+
+    /**
+     * @brief Sends header and payload of *message* by a single
+     *        sendmsg, thus a borrowed payload is not copied.
+     */
+    template <typename T_Socket> void sendToSocket(T_Socket& socket, Message& message)
+    {
+        socket.send(message.getMessage(), message.payload, message.payloadSize);
+    }
+
+    /**
+     * @brief With Config::ioUring, the batches flushed together are
+     *        queued and sent by a single submission. Only batches
+     *        share the send queue, all under sendMtx.
+     */
+    void beginBatchSends()
+    {
+        deferSends = sendQueue != nullptr;
+    }
+
+    void sendBatchToSocket(Socket& socket, Message& batch, std::vector<std::int8_t>& frames)
+    {
+        if (deferSends) {
+            sendQueue->push(socket, batch.getMessage(), frames);
+        } else {
+            sendToSocket(socket, batch);
+        }
+    }
+
+    void endBatchSends()
+    {
+        if (deferSends) {
+            deferSends = false;
+            sendQueue->submit();
+        }
+    }
+
+    /** @} */
+
+    Uri bindToNextFreePort(Socket& socket, const std::string peerUri)
+    {
+        std::string peerBaseUri = peerUri.substr(0, peerUri.rfind(":"));
+        unsigned peerBasePort = std::stoi(peerUri.substr(peerUri.rfind(":") + 1));
+
+        while (true) {
+            const std::string uri = peerBaseUri + ":" + std::to_string(peerBasePort);
+            try {
+                socket.bind(uri);
+                return uri;
+            } catch (std::system_error const& e) {
+                if (e.code().value() != EADDRINUSE) {
+                    throw;
+                }
+                peerBasePort++;
+            }
+        }
+    }
+
+}; // class TCP
+} // namespace communicationPolicy
+} // namespace graybat
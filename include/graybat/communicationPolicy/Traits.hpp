@@ -52,7 +52,14 @@ enum class MsgTypeType : std::int8_t {
     CONTEXT_REQUEST = 6,
     PEER = 7,
     CONFIRM = 8,
-    SPLIT = 9
+    SPLIT = 9,
+    BOOTSTRAP = 10,
+    BATCH = 11,
+    REQUEST_TO_SEND = 12,
+    CLEAR_TO_SEND = 13,
+    RENDEZVOUS = 14,
+    MULTICAST = 15,
+    PUBLISH = 16
 };
 
 template <typename T_CommunicationPolicy> using MsgType = MsgTypeType;
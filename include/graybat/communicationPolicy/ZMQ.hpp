@@ -23,14 +23,21 @@
 // Clib
 #include <assert.h>
 #include <string.h>
+#include <unistd.h>
 
 // Stl
 #include <array>
 #include <exception>
 #include <iostream>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 // Zmq
 #include <zmq.hpp>
@@ -40,6 +47,7 @@
 #include <graybat/communicationPolicy/socket/Base.hpp> /* Base */
 #include <graybat/communicationPolicy/zmq/Config.hpp> /* Config */
 #include <graybat/communicationPolicy/zmq/Context.hpp> /* Context */
+#include <graybat/communicationPolicy/zmq/Endpoints.hpp> /* Endpoints */
 #include <graybat/communicationPolicy/zmq/Event.hpp> /* Event */
 #include <graybat/communicationPolicy/zmq/Message.hpp> /* Message */
 #include <graybat/communicationPolicy/zmq/Status.hpp> /* Event */
@@ -111,30 +119,77 @@ struct ZMQ : public graybat::communicationPolicy::socket::Base<ZMQ> {
     using Socket = graybat::communicationPolicy::socket::Socket<ZMQ>;
     using Message = graybat::communicationPolicy::socket::Message<ZMQ>;
     using SocketBase = graybat::communicationPolicy::socket::Base<ZMQ>;
+    template <typename T_Socket>
+    using SocketPool = graybat::communicationPolicy::socket::SocketPool<T_Socket>;
 
     // ZMQ Sockets
-    ::zmq::context_t zmqContext;
+    std::shared_ptr<::zmq::context_t> zmqContext;
     Socket recvSocket;
     Socket ctrlSocket;
-    std::vector<Socket> sendSockets;
-    std::vector<Socket> ctrlSendSockets;
-
-    // Uri
+    SocketPool<Socket> sendSockets;
+    SocketPool<Socket> ctrlSendSockets;
+    SocketPool<Socket> railSendSockets;
+
+    // Broadcasts are published on pubSocket to the subSocket of
+    // every other peer, see Config::publishBroadcasts. pubMtx
+    // guards pubSocket and subscribers, the subscriber thread owns
+    // subSocket and subscribes to the topics in newSubscriptions.
+    const bool publishBroadcasts;
+    Socket pubSocket;
+    Socket subSocket;
+    std::mutex pubMtx;
+    std::map<std::string, std::size_t> subscribers;
+    std::mutex subscriptionMtx;
+    std::set<std::string> subscriptions;
+    std::vector<std::string> newSubscriptions;
+    std::atomic<bool> stopSubscriber;
+    std::thread subscriber;
+
+    // Endpoints of this peer, thus connectToSocket can select
+    // the cheapest endpoint of a remote peer
+    const bool localTransports;
+    const std::string ipcDir;
+    zmq::Endpoints localEndpoints;
+
+    // Uri, encoded Endpoints
     const Uri peerUri;
     const Uri ctrlUri;
 
     // Construct
     ZMQ(Config const config)
         : SocketBase(config)
-        , zmqContext(1)
-        , recvSocket(zmqContext, ZMQ_PULL)
-        , ctrlSocket(zmqContext, ZMQ_PULL)
-        , peerUri(bindToNextFreePort(recvSocket, config.peerUri))
-        , ctrlUri(bindToNextFreePort(ctrlSocket, config.peerUri))
+        , zmqContext(getSharedContext(config.ioThreads))
+        , recvSocket(*zmqContext, ZMQ_PULL)
+        , ctrlSocket(*zmqContext, ZMQ_PULL)
+        , sendSockets(config.maxSendSockets)
+        , ctrlSendSockets(config.maxSendSockets)
+        , railSendSockets(config.maxSendSockets * (std::max<size_t>(config.nRails, 1) - 1))
+        , publishBroadcasts(config.publishBroadcasts)
+        , pubSocket(*zmqContext, ZMQ_XPUB)
+        , subSocket(*zmqContext, ZMQ_SUB)
+        , stopSubscriber(false)
+        , localTransports(config.localTransports)
+        , ipcDir(config.ipcDir)
+        , localEndpoints(getLocalEndpoints())
+        , peerUri(bindPublisher(bindEndpoints(recvSocket, config.peerUri), config.peerUri))
+        , ctrlUri(bindEndpoints(ctrlSocket, config.peerUri))
     {
 
         // std::cout << "--> ZMQ" << std::endl;
         SocketBase::init();
+
+        if (publishBroadcasts) {
+            subSocket.setsockopt(ZMQ_RCVHWM, 0);
+            for (auto const& vAddr : initialContext) {
+                if (vAddr != initialContext.getVAddr()) {
+                    Uri const& uri = phoneBook.at(initialContext.getID()).at(vAddr);
+                    subSocket.connect(zmq::Endpoints::decode(uri.substr(uri.find('|') + 1))
+                                          .select(localEndpoints)
+                                          .c_str());
+                }
+            }
+            subscriber = std::thread(&ZMQ::handleSubscriptions, this);
+        }
         // std::cout << "<-- ZMQ" << std::endl;
     }
 
@@ -150,29 +205,74 @@ struct ZMQ : public graybat::communicationPolicy::socket::Base<ZMQ> {
     // Destructor
     ~ZMQ()
     {
+        if (subscriber.joinable()) {
+            stopSubscriber = true;
+            subscriber.join();
+        }
         SocketBase::deinit();
     }
 
     /***********************************************************************/ /**
       *
-      * @name Socket base utilities
+      * @name Collective Communication Interface
       *
       * @{
       *
       ***************************************************************************/
 
-    void createSocketsToPeers()
+    /**
+     * @brief Sends *data* of the peer with *rootVAddr* to all peers
+     *        of the *context*. With Config::publishBroadcasts the root
+     *        publishes the data once, otherwise it sends it to every
+     *        peer.
+     */
+    template <typename T_SendRecv>
+    void broadcast(const VAddr rootVAddr, const Context context, T_SendRecv& data)
     {
-        for (auto const& vAddr : initialContext) {
-            (void)vAddr;
-            sendSockets.emplace_back(Socket(zmqContext, ZMQ_PUSH));
-            ctrlSendSockets.emplace_back(Socket(zmqContext, ZMQ_PUSH));
+        if (!publishBroadcasts) {
+            SocketBase::broadcast(rootVAddr, context, data);
+            return;
+        }
+
+        const Tag tag = 0;
+        if (rootVAddr == context.getVAddr()) {
+            publish(context, tag, data);
+        } else {
+            subscribe(getTopic(context.getID(), tag));
+            recvImpl(MsgType::PUBLISH, context, rootVAddr, tag, data);
         }
     }
 
+    /** @} */
+
+    /***********************************************************************/ /**
+      *
+      * @name Socket base utilities
+      *
+      * @{
+      *
+      ***************************************************************************/
+
     template <typename T_Socket> void connectToSocket(T_Socket& socket, std::string const uri)
     {
-        socket.connect(uri.c_str());
+        // Endpoints of the publisher follow behind a '|'
+        socket.connect(
+            zmq::Endpoints::decode(uri.substr(0, uri.find('|'))).select(localEndpoints).c_str());
+    }
+
+    template <typename T_Socket> void bindToSocket(T_Socket& socket, std::string const uri)
+    {
+        socket.bind(uri.c_str());
+    }
+
+    template <typename T_Socket> void unbindFromSocket(T_Socket& socket, std::string const uri)
+    {
+        socket.unbind(uri.c_str());
+    }
+
+    Socket createSendSocket()
+    {
+        return Socket(*zmqContext, ZMQ_PUSH);
     }
 
     template <typename T_Socket> void recvFromSocket(T_Socket& socket, std::stringstream& ss)
@@ -185,6 +285,7 @@ struct ZMQ : public graybat::communicationPolicy::socket::Base<ZMQ> {
     template <typename T_Socket> void recvFromSocket(T_Socket& socket, Message& message)
     {
         socket.recv(&message.getMessage());
+        message.decodeHeader();
     }
 
     template <typename T_Socket> void sendToSocket(T_Socket& socket, std::stringstream const& ss)
@@ -200,6 +301,189 @@ struct ZMQ : public graybat::communicationPolicy::socket::Base<ZMQ> {
         socket.send(data);
     }
 
+    /**
+     * @brief ZMQ sends in the background, thus its messages own a
+     *        copy of their payload.
+     */
+    template <typename T_Socket> void sendToSocket(T_Socket& socket, Message& message)
+    {
+        socket.send(message.getMessage());
+    }
+
+    /**
+     * @brief Binds *socket* to the next free tcp port starting at
+     *        *peerUri* and, if local transports are enabled, to
+     *        an ipc and an inproc endpoint.
+     *
+     * @return The endpoints encoded as uri
+     */
+    Uri bindEndpoints(Socket& socket, const std::string peerUri)
+    {
+        zmq::Endpoints endpoints;
+        endpoints.tcp = bindToNextFreePort(socket, peerUri);
+
+        if (localTransports) {
+            static std::atomic<unsigned> nEndpoints(0);
+            const std::string name
+                = "graybat-" + std::to_string(::getpid()) + "-" + std::to_string(nEndpoints++);
+
+            endpoints.hostId = localEndpoints.hostId;
+            endpoints.processId = localEndpoints.processId;
+            endpoints.ipc = "ipc://" + ipcDir + "/" + name;
+            endpoints.inproc = "inproc://" + name;
+            socket.bind(endpoints.ipc.c_str());
+            socket.bind(endpoints.inproc.c_str());
+        }
+
+        return endpoints.encode();
+    }
+
+    /**
+     * @brief Binds the publisher if broadcasts are published.
+     *
+     * @return *dataUri* followed by the endpoints of the publisher
+     */
+    Uri bindPublisher(Uri const dataUri, const std::string peerUri)
+    {
+        if (!publishBroadcasts) {
+            return dataUri;
+        }
+
+        // Subscriptions of all peers reach the publisher, not just
+        // the first one of a topic
+        pubSocket.setsockopt(ZMQ_SNDHWM, 0);
+        pubSocket.setsockopt(ZMQ_XPUB_VERBOSE, 1);
+        return dataUri + "|" + bindEndpoints(pubSocket, peerUri);
+    }
+
+    /**
+     * @brief Topic of the broadcasts with *tag* in a context.
+     */
+    static std::string getTopic(ContextID const contextID, Tag const tag)
+    {
+        std::string topic(sizeof(contextID) + sizeof(tag), '\0');
+        memcpy(&topic[0], &contextID, sizeof(contextID));
+        memcpy(&topic[sizeof(contextID)], &tag, sizeof(tag));
+        return topic;
+    }
+
+    /**
+     * @brief Publishes *data* to the peers of *context* once all of
+     *        them subscribed to the topic of *context* and *tag*.
+     */
+    template <typename T_Send> void publish(Context const context, Tag const tag, T_Send& data)
+    {
+        const std::string topic = getTopic(context.getID(), tag);
+        Message message(MsgType::PUBLISH, 0, context.getID(), context.getVAddr(), tag, data);
+
+        std::lock_guard<std::mutex> lock(pubMtx);
+        recvSubscriptions(0);
+        while (subscribers[topic] + 1 < context.size()) {
+            recvSubscriptions(100);
+        }
+
+        ::zmq::message_t topicFrame(topic.data(), topic.size());
+        pubSocket.send(topicFrame, ZMQ_SNDMORE);
+        pubSocket.send(message.getMessage());
+    }
+
+    /**
+     * @brief Counts the subscriptions which arrived at the publisher
+     *        within *timeout* milliseconds. Needs pubMtx.
+     */
+    void recvSubscriptions(long timeout)
+    {
+        ::zmq::pollitem_t items[] = { { static_cast<void*>(pubSocket), 0, ZMQ_POLLIN, 0 } };
+        while (::zmq::poll(items, 1, timeout) > 0) {
+            ::zmq::message_t subscription;
+            pubSocket.recv(&subscription);
+
+            // First byte is 1 for subscribe and 0 for unsubscribe
+            const char* bytes = static_cast<const char*>(subscription.data());
+            if (subscription.size() > 0) {
+                std::size_t& count = subscribers[std::string(bytes + 1, subscription.size() - 1)];
+                if (bytes[0] == 1) {
+                    count++;
+                } else if (count > 0) {
+                    count--;
+                }
+            }
+            timeout = 0;
+        }
+    }
+
+    /**
+     * @brief Subscribes to *topic* unless already subscribed. The
+     *        subscriber thread applies the subscription.
+     */
+    void subscribe(std::string const& topic)
+    {
+        std::lock_guard<std::mutex> lock(subscriptionMtx);
+        if (subscriptions.insert(topic).second) {
+            newSubscriptions.push_back(topic);
+        }
+    }
+
+    /**
+     * @brief Receives published messages and passes them on like
+     *        messages of the recvSocket.
+     */
+    void handleSubscriptions()
+    {
+        ::zmq::pollitem_t items[] = { { static_cast<void*>(subSocket), 0, ZMQ_POLLIN, 0 } };
+
+        while (!stopSubscriber) {
+            {
+                std::lock_guard<std::mutex> lock(subscriptionMtx);
+                for (auto const& topic : newSubscriptions) {
+                    subSocket.setsockopt(ZMQ_SUBSCRIBE, topic.data(), topic.size());
+                }
+                newSubscriptions.clear();
+            }
+
+            if (::zmq::poll(items, 1, 10) <= 0) {
+                continue;
+            }
+
+            ::zmq::message_t topic;
+            subSocket.recv(&topic);
+            Message message;
+            recvFromSocket(subSocket, message);
+            dispatchRecv(message);
+        }
+    }
+
+    zmq::Endpoints getLocalEndpoints() const
+    {
+        zmq::Endpoints endpoints;
+        endpoints.hostId = zmq::Endpoints::localHostId();
+
+        // inproc needs a shared ZMQ context
+        std::ostringstream processId;
+        processId << ::getpid() << "-" << zmqContext.get();
+        endpoints.processId = processId.str();
+        return endpoints;
+    }
+
+    /**
+     * @brief Peers in the same process share a ZMQ context,
+     *        thus they can reach each other over inproc. The
+     *        first peer decides on the number of I/O threads.
+     */
+    static std::shared_ptr<::zmq::context_t> getSharedContext(int ioThreads)
+    {
+        static std::mutex mtx;
+        static std::weak_ptr<::zmq::context_t> sharedContext;
+
+        std::lock_guard<std::mutex> lock(mtx);
+        std::shared_ptr<::zmq::context_t> context = sharedContext.lock();
+        if (!context) {
+            context = std::make_shared<::zmq::context_t>(ioThreads);
+            sharedContext = context;
+        }
+        return context;
+    }
+
     Uri bindToNextFreePort(Socket& socket, const std::string peerUri)
     {
         std::string peerBaseUri = peerUri.substr(0, peerUri.rfind(":"));
@@ -21,6 +21,14 @@
 #pragma once
 
 #include <boost/mpi/environment.hpp>
+#include <boost/mpi/request.hpp>
+#include <boost/mpi/status.hpp>
+
+#include <mpi.h>
+
+#include <atomic>
+#include <mutex>
+#include <utility> /* std::move */
 
 namespace graybat {
 
@@ -28,6 +36,93 @@ namespace communicationPolicy {
 
 namespace bmpi {
 
+/**
+ * @brief Plain MPI request shared by all copies of an event, thus
+ *        it is completed once and each copy sees the completion.
+ *
+ * Released requests are kept in a free list, thus events only
+ * allocate until the list holds as many requests as are in flight
+ * at once.
+ */
+class SharedRequest {
+  public:
+    static SharedRequest* acquire(MPI_Request request)
+    {
+        SharedRequest* shared = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(pool().mtx);
+            shared = pool().free;
+            if (shared) {
+                pool().free = shared->next;
+            }
+        }
+        if (!shared) {
+            shared = new SharedRequest();
+        }
+        shared->request = request;
+        shared->nRefs = 1;
+        return shared;
+    }
+
+    void retain()
+    {
+        nRefs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release()
+    {
+        if (nRefs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(pool().mtx);
+            next = pool().free;
+            pool().free = this;
+        }
+    }
+
+    // The status is only set by the call which completes the request
+    boost::mpi::status& wait()
+    {
+        if (request != MPI_REQUEST_NULL) {
+            MPI_Wait(&request, &static_cast<MPI_Status&>(status));
+        }
+        return status;
+    }
+
+    bool test()
+    {
+        if (request != MPI_REQUEST_NULL) {
+            int done = 0;
+            MPI_Test(&request, &done, &static_cast<MPI_Status&>(status));
+        }
+        return request == MPI_REQUEST_NULL;
+    }
+
+  private:
+    struct Pool {
+        ~Pool()
+        {
+            while (free) {
+                SharedRequest* next = free->next;
+                delete free;
+                free = next;
+            }
+        }
+
+        std::mutex mtx;
+        SharedRequest* free = nullptr;
+    };
+
+    static Pool& pool()
+    {
+        static Pool pool;
+        return pool;
+    }
+
+    MPI_Request request;
+    boost::mpi::status status;
+    std::atomic<unsigned> nRefs;
+    SharedRequest* next;
+};
+
 /**
  * @brief An event is returned by non-blocking
  *        communication operations and can be
@@ -35,6 +130,8 @@ namespace bmpi {
  *        or it can be waited for this operation to
  *        be finished.
  *
+ *        Events of plain MPI requests do not allocate
+ *        once their shared requests are recycled.
  */
 class Event {
     typedef unsigned Tag;
@@ -43,31 +140,91 @@ class Event {
   public:
     Event(boost::mpi::request request)
         : request(request)
+        , rawRequest(nullptr)
         , async(true)
+        , raw(false)
+    {
+    }
+
+    Event(MPI_Request rawRequest)
+        : rawRequest(SharedRequest::acquire(rawRequest))
+        , async(true)
+        , raw(true)
     {
     }
 
     Event(boost::mpi::status status)
         : status(status)
+        , rawRequest(nullptr)
         , async(false)
+        , raw(false)
+    {
+    }
+
+    Event(const Event& other)
+        : request(other.request)
+        , status(other.status)
+        , rawRequest(other.rawRequest)
+        , async(other.async)
+        , raw(other.raw)
+    {
+        if (rawRequest) {
+            rawRequest->retain();
+        }
+    }
+
+    Event(Event&& other) noexcept
+        : request(std::move(other.request))
+        , status(other.status)
+        , rawRequest(other.rawRequest)
+        , async(other.async)
+        , raw(other.raw)
     {
+        other.rawRequest = nullptr;
     }
 
-    Event& operator=(const Event&) = default;
+    Event& operator=(const Event& other)
+    {
+        return *this = Event(other);
+    }
+
+    Event& operator=(Event&& other) noexcept
+    {
+        if (this != &other) {
+            if (rawRequest) {
+                rawRequest->release();
+            }
+            request = std::move(other.request);
+            status = other.status;
+            rawRequest = other.rawRequest;
+            async = other.async;
+            raw = other.raw;
+            other.rawRequest = nullptr;
+        }
+        return *this;
+    }
 
     ~Event()
     {
+        if (rawRequest) {
+            rawRequest->release();
+        }
     }
 
     void wait()
     {
-        if (async) {
+        if (raw) {
+            rawRequest->wait();
+        } else if (async) {
             request.wait();
         }
     }
 
     bool ready()
     {
+        if (raw) {
+            return rawRequest->test();
+        }
         if (async) {
             boost::optional<boost::mpi::status> status = request.test();
 
@@ -82,7 +239,9 @@ class Event {
 
     VAddr source()
     {
-        if (async) {
+        if (raw) {
+            status = rawRequest->wait();
+        } else if (async) {
             status = request.wait();
         }
         return status.source();
@@ -90,7 +249,9 @@ class Event {
 
     Tag getTag()
     {
-        if (async) {
+        if (raw) {
+            status = rawRequest->wait();
+        } else if (async) {
             status = request.wait();
         }
         return status.tag();
@@ -99,7 +260,9 @@ class Event {
   private:
     boost::mpi::request request;
     boost::mpi::status status;
+    SharedRequest* rawRequest;
     bool async;
+    bool raw;
 };
 
 } // namespace bmpi
@@ -21,14 +21,28 @@
 #pragma once
 
 // Stl
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <exception>
+#include <future>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <vector>
 
 // Boost
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/strand.hpp>
 #include <boost/optional.hpp>
 #include <boost/utility/in_place_factory.hpp>
 
@@ -38,12 +52,13 @@
 // GrayBat
 #include <graybat/communicationPolicy/Base.hpp>
 #include <graybat/communicationPolicy/Traits.hpp>
+#include <graybat/communicationPolicy/socket/SocketPool.hpp>
 #include <graybat/communicationPolicy/socket/Traits.hpp>
-#include <graybat/signaling/GrpcSignalingClient.hpp>
+#include <graybat/communicationPolicy/socket/WireHeader.hpp>
+#include <graybat/signaling/SignalingBackend.hpp>
+#include <graybat/signaling/makeSignalingBackend.hpp>
 #include <graybat/utils/MultiKeyMap.hpp>
 
-#define PROTOCOL_HEADER_SIZE_IN_BYTES 17
-
 namespace hana = boost::hana;
 
 namespace graybat {
@@ -76,6 +91,11 @@ struct Base : graybat::communicationPolicy::Base<T_CommunicationPolicy> {
     const ContextName contextName;
     unsigned maxMsgID;
     std::mutex sendMtx;
+
+    // Guards the ctrl send sockets. Confirms are sent by the receiving
+    // threads, which must not wait for a data send blocked by the peer
+    // that waits for exactly this confirm. Taken after sendMtx.
+    std::mutex ctrlSendMtx;
     std::map<ContextID, std::map<VAddr, std::size_t>> sendSocketMappings;
     utils::MessageBox<Message, MsgType, ContextID, VAddr, Tag> inBox;
     utils::MessageBox<Message, MsgType, ContextID, VAddr, Tag> ctrlBox;
@@ -89,10 +109,99 @@ struct Base : graybat::communicationPolicy::Base<T_CommunicationPolicy> {
     std::map<ContextID, std::map<Uri, VAddr>> inverseCtrlPhoneBook;
     std::map<ContextID, ContextName> contextNames;
 
+    // Split contexts take odd ids 2 * n + 1, contexts of the signaling
+    // even ones. n is agreed on by the peers of the split, it is the
+    // highest nextSplitID among them, thus a peer never takes part in
+    // two contexts with the same id.
+    unsigned nextSplitID;
+
+    // Guards contexts and sendSocketMappings, which are
+    // read by the recvHandler while contexts are split
+    std::mutex contextMtx;
+
+    // Confirmations of messages that arrived before their
+    // context was created by splitContext on this peer
+    std::map<ContextID, std::vector<std::tuple<MsgID, VAddr, Tag>>> pendingConfirms;
+
+    // Uris of the send sockets, indexed like sendSocketMappings
+    std::vector<Uri> sendUris;
+    std::vector<Uri> ctrlSendUris;
+
+    // A data socket is only closed when all messages sent on it
+    // are confirmed, otherwise a new connection to the same peer
+    // could overtake them. Guarded by sendMtx, but nUnconfirmed
+    // which is decremented by the ctrlHandler.
+    std::vector<std::atomic<unsigned>> nUnconfirmed;
+    std::vector<bool> lastSendConfirmable;
+
+    // Tree bootstrap, see Config
+    const size_t bootstrapGroupSize;
+    const size_t bootstrapRank;
+    const std::string bootstrapDir;
+
     std::thread recvHandler;
     std::thread ctrlHandler;
 
-    graybat::signaling::GrpcSignalingClient signalingClient_;
+    // Receive workers, the recvHandler only receives and passes
+    // messages on. Messages of a source are processed in order by
+    // the same strand. Without workers the recvHandler processes
+    // messages itself.
+    const size_t nRecvWorkers;
+    boost::asio::io_service recvService;
+    std::unique_ptr<boost::asio::io_service::work> recvWork;
+    std::vector<std::unique_ptr<boost::asio::io_service::strand>> recvStrands;
+    std::vector<std::thread> recvWorkers;
+
+    // Batches of small peer messages per send socket, each message
+    // is prefixed by its size. Guarded by sendMtx.
+    struct Batch {
+        std::vector<std::int8_t> frames;
+        std::chrono::steady_clock::time_point since;
+    };
+    const size_t batchSize;
+    const std::chrono::microseconds batchTimeout;
+    std::vector<Batch> batches;
+    bool stopBatchFlusher;
+    std::condition_variable batchFlusherWakeup;
+    std::thread batchFlusher;
+
+    // Rendezvous of large peer messages: the sender references the
+    // payload of the user, which stays alive until the send is
+    // confirmed, and sends it once the receiver posted its buffer.
+    // The recvHandler copies it right into that buffer. Keyed by
+    // context, peer and msg id. Cleared payloads are sent in segments
+    // of up to chunkSize bytes, one segment of each cleared payload
+    // in turn. Consecutive segments take consecutive rails, the data
+    // connections to a peer.
+    using RendezvousKey = std::tuple<ContextID, VAddr, MsgID>;
+    struct RendezvousSend {
+        Context context;
+        Tag tag;
+        const std::int8_t* data;
+        std::size_t size;
+        std::size_t sent;
+        std::size_t rail;
+    };
+    struct PostedRecv {
+        std::int8_t* data;
+        std::size_t size;
+        std::size_t expected;
+        std::size_t received;
+        std::promise<void> done;
+    };
+    const size_t chunkSize;
+    const size_t nRails;
+    const size_t rendezvousThreshold;
+    std::mutex rendezvousMtx;
+    std::map<RendezvousKey, RendezvousSend> rendezvousSends;
+    std::map<RendezvousKey, PostedRecv> postedRecvs;
+    std::deque<RendezvousKey> clearedSends;
+    bool stopRendezvousSender;
+    std::condition_variable rendezvousSenderWakeup;
+    std::thread rendezvousSender;
+
+    // Grpc signaling server or file based, selected by config.masterUri
+    std::unique_ptr<graybat::signaling::SignalingBackend> signaling_;
 
     // Constructor
     Base(Config const config);
@@ -114,18 +223,63 @@ struct Base : graybat::communicationPolicy::Base<T_CommunicationPolicy> {
     template <typename T_Socket>
     void connectToSocket(T_Socket& socket, std::string const uri) = delete;
 
+    template <typename T_Socket> void bindToSocket(T_Socket& socket, std::string const uri) = delete;
+
+    template <typename T_Socket>
+    void unbindFromSocket(T_Socket& socket, std::string const uri) = delete;
+
+    Socket createSendSocket() = delete;
+
     template <typename T_Socket>
     void sendToSocket(T_Socket& socket, std::stringstream const ss) = delete;
 
     template <typename T_Socket, typename T_Data>
     void sendToSocket(T_Socket& socket, T_Data const data) = delete;
 
+    /**
+     * @brief Sends the *batch* message of a flushed batch, by
+     *        sendToSocket unless the policy defers batches. The
+     *        message borrows *frames*, a policy that defers it may
+     *        swap them with an empty buffer. Needs sendMtx.
+     */
+    void sendBatchToSocket(Socket& socket, Message& batch, std::vector<std::int8_t>& frames);
+
+    /**
+     * @brief Enclose the batches flushed together by flush() or
+     *        the batch timeout, a policy may send them at once by
+     *        endBatchSends(). Need sendMtx.
+     */
+    void beginBatchSends()
+    {
+    }
+
+    void endBatchSends()
+    {
+    }
+
     template <typename T_Socket>
     void recvFromSocket(T_Socket& socket, std::stringstream ss) = delete;
 
     template <typename T_Socket> void recvFromSocket(T_Socket& socket, Message& message) = delete;
 
-    void createSocketsToPeers() = delete;
+    /**
+     * @brief Returns the data send socket with index *sendSocket_i*,
+     *        connected on first use. Needs sendMtx.
+     */
+    Socket& getSendSocket(std::size_t const sendSocket_i);
+
+    /**
+     * @brief Returns the ctrl send socket with index *sendSocket_i*,
+     *        connected on first use. Needs ctrlSendMtx.
+     */
+    Socket& getCtrlSendSocket(std::size_t const sendSocket_i);
+
+    /**
+     * @brief Returns the data send socket of *rail* to the peer with
+     *        index *sendSocket_i*, rail 0 is its regular data socket.
+     *        Needs sendMtx.
+     */
+    Socket& getRailSendSocket(std::size_t const sendSocket_i, std::size_t const rail);
 
     // P2P INTERFACE
 
@@ -156,6 +310,9 @@ struct Base : graybat::communicationPolicy::Base<T_CommunicationPolicy> {
      *                       to the data memory address. And the function size(), that
      *                       return the amount of data elements to send. Notice, that
      *                       std::vector and std::array implement this interface.
+     *                       Payloads above the rendezvous threshold are sent from
+     *                       sendData, thus it needs to stay alive until the event
+     *                       is ready.
      *
      * @return Event
      */
@@ -183,6 +340,22 @@ struct Base : graybat::communicationPolicy::Base<T_CommunicationPolicy> {
     template <typename T_Recv>
     Event asyncRecv(const VAddr srcVAddr, const Tag tag, const Context context, T_Recv& recvData);
 
+    /**
+     * @brief Non blocking transmission of the same *sendData* with
+     *        each of *tags* to the peer with virtual address
+     *        *destVAddr*. The data is sent once together with the
+     *        list of tags, the receiving peer delivers a message
+     *        per tag. Payloads above the rendezvous threshold are
+     *        sent per tag.
+     */
+    template <typename T_Send>
+    void asyncMulticast(
+        const VAddr destVAddr,
+        const std::vector<Tag>& tags,
+        const Context context,
+        const T_Send& sendData,
+        std::vector<Event>& events);
+
     /** Blocks until a message for srcVAddr and tag is available
      *   and returns a status object for it
      *
@@ -197,7 +370,7 @@ struct Base : graybat::communicationPolicy::Base<T_CommunicationPolicy> {
     Status probe(VAddr srcVAddr, Tag tag, const Context& context)
     {
         auto result = inBox.waitProbe(MsgType::PEER, context.getID(), srcVAddr, tag);
-        return Status{ srcVAddr, tag, result - PROTOCOL_HEADER_SIZE_IN_BYTES };
+        return Status{ srcVAddr, tag, result };
     }
 
     /** If a message for srcVAddr and tag is available, a status object is returned.
@@ -213,26 +386,83 @@ struct Base : graybat::communicationPolicy::Base<T_CommunicationPolicy> {
     boost::optional<Status> asyncProbe(const VAddr srcVAddr, const Tag tag, const Context context){
         auto result = inBox.tryProbe(MsgType::PEER, context.getID(), srcVAddr, tag);
         if (result) {
-            return Status{ srcVAddr, tag, result - PROTOCOL_HEADER_SIZE_IN_BYTES };
+            return Status{ srcVAddr, tag, *result };
         } else {
             return boost::none;
         }
     }
 
+    /**
+     * @brief Sends all batched messages.
+     */
+    void flush();
+
     // EVENT INTERFACE
     bool ready(const MsgID msgID, const Context context, const VAddr vAddr, const Tag tag);
 
     // CONTEXT INTERFACE
     Context getGlobalContext();
+
+    /**
+     * @brief Creates a new context from the members of *oldContext*
+     *        with *isMember* set, without contacting the signaling server.
+     *        The VAddrs of the new context are 0,...,size()-1 ordered by the
+     *        VAddrs in the *oldContext*. Peers that are no members receive
+     *        an invalid context.
+     */
     Context splitContext(const bool isMember, const Context oldContext);
 
-    // SIGNALING METHODS
+    // SIGNALING METHODS, ids of the signaling are doubled to be even
     ContextID getContextID(const ContextName& contextName);
 
     VAddr getVAddr(ContextID contextID, Uri const& uri, Uri const& ctrlUri);
 
+    /**
+     * @brief Throws when *vAddr* is not below *contextSize*, then the
+     *        signaling still holds peers of an earlier job, which
+     *        would be waited for forever.
+     */
+    void checkVAddr(VAddr vAddr, const ContextName& contextName, std::size_t contextSize);
+
     std::pair<Uri, Uri> getUri(ContextID contextID, VAddr vAddr);
 
+    /**
+     * @brief Returns the data and ctrl uris of all *contextSize* peers
+     *        of a context ordered by VAddr. Blocks until all peers
+     *        registered at the signaling backend.
+     */
+    std::vector<std::pair<Uri, Uri>> getUris(ContextID contextID, std::size_t contextSize);
+
+    // TREE BOOTSTRAP
+    using BootstrapEntry = std::tuple<VAddr, Uri, Uri>;
+
+    enum BootstrapTag : Tag { BOOTSTRAP_FRAGMENT = 0, BOOTSTRAP_BOOK = 1 };
+
+    /**
+     * @brief Retrieves the id and the uris of the initial context
+     *        without registering every peer at the signaling server.
+     *
+     * Only the first peer of each group of bootstrapGroupSize peers,
+     * the group leader, contacts the signaling server. It requests
+     * the id of the initial context, but registers its VAddr only in
+     * the context '<name>/leaders'. Members send their uris to their
+     * leader, leaders gather the fragments
+     * of their subtree in a k-ary tree of leaders and the complete
+     * phone book is relayed down the same tree to all members. The
+     * VAddr of a peer is its bootstrapRank.
+     */
+    std::pair<ContextID, std::vector<std::pair<Uri, Uri>>> bootstrapTree();
+
+    void sendBootstrap(
+        Socket& socket,
+        BootstrapTag const tag,
+        ContextID const contextID,
+        std::vector<BootstrapEntry> const& entries);
+
+    std::vector<BootstrapEntry> recvBootstrap(BootstrapTag const tag, ContextID& contextID);
+
+    bool isBootstrapLeader() const;
+
     // Auxilary
     template <typename T_Send>
     void asyncSendImpl(
@@ -243,6 +473,12 @@ struct Base : graybat::communicationPolicy::Base<T_CommunicationPolicy> {
         Tag const tag,
         T_Send& sendData);
 
+    /**
+     * @brief Sends a message on the socket of *destVAddr*, batches
+     *        it or sends it on the ctrl socket depending on its type.
+     */
+    void postMessage(Context const context, VAddr const destVAddr, Message& message);
+
     template <typename T_Recv>
     void recvImpl(
         MsgType const msgType,
@@ -274,6 +510,51 @@ struct Base : graybat::communicationPolicy::Base<T_CommunicationPolicy> {
 
     void handleRecv();
     void handleCtrl();
+
+    /**
+     * @brief Confirms a received message and delivers it to the inBox.
+     */
+    void processRecv(Message& message);
+
+    /**
+     * @brief Processes a received message in the recvHandler or
+     *        passes it on to the receive worker of its source.
+     */
+    void dispatchRecv(Message& message);
+
+    // Batching, need sendMtx
+    void appendToBatch(std::size_t const sendSocket_i, Message& message);
+    void flushBatch(std::size_t const sendSocket_i);
+
+    /**
+     * @brief Sends batches older than the batch timeout.
+     */
+    void handleBatches();
+
+    /**
+     * @brief Copies the payload of a dequeued peer message to
+     *        *recvData*. For a request to send, posts *recvData*
+     *        to the sender and blocks until the payload arrived.
+     */
+    void copyPayload(Message& message, Context const context, void* recvData, size_t const size);
+
+    /**
+     * @brief Queues the payload of a rendezvous message, which the
+     *        receiver *vAddr* cleared to send.
+     */
+    void clearToSend(ContextID const contextID, VAddr const vAddr, MsgID const msgID);
+
+    /**
+     * @brief Sends the segments of cleared rendezvous payloads.
+     */
+    void handleRendezvous();
+
+    /**
+     * @brief Copies a rendezvous segment into its posted buffer.
+     *
+     * @return true when it was the last segment of the payload
+     */
+    bool recvSegment(Message& message);
 };
 
 template <typename T_CommunicationPolicy>
@@ -283,7 +564,20 @@ Base<T_CommunicationPolicy>::Base(Config const config)
     , maxMsgID(0)
     , inBox(config.maxBufferSize)
     , ctrlBox(config.maxBufferSize)
-    , signalingClient_(config.masterUri)
+    , nextSplitID(0)
+    , bootstrapGroupSize(config.bootstrapGroupSize)
+    , bootstrapRank(config.bootstrapRank)
+    , bootstrapDir(config.bootstrapDir)
+    , nRecvWorkers(config.nRecvWorkers)
+    , batchSize(config.batchSize)
+    , batchTimeout(config.batchTimeoutUs)
+    , stopBatchFlusher(false)
+    , chunkSize(config.chunkSize)
+    , nRails(std::max<size_t>(config.nRails, 1))
+    , rendezvousThreshold(
+          config.rendezvousThreshold > 0 ? config.rendezvousThreshold : config.chunkSize)
+    , stopRendezvousSender(false)
+    , signaling_(graybat::signaling::makeSignalingBackend(config.masterUri))
 {
     //                std::cout << "--> Base" << std::endl;
     //                std::cout << "<-- Base" << std::endl;
@@ -297,50 +591,72 @@ template <typename T_CommunicationPolicy> auto Base<T_CommunicationPolicy>::init
 {
     // std::cout << "--> init" << std::endl;
 
-    // Retrieve Context id for initial context from signaling process
-    ContextID contextID = getContextID(contextName);
-    contextNames[contextID] = contextName;
+    ContextID contextID = 0;
+    VAddr vAddr = 0;
+    std::vector<std::pair<Uri, Uri>> uris;
 
-    // Retrieve own vAddr from signaling process for initial context
-    VAddr vAddr = getVAddr(
-        contextID,
-        static_cast<CommunicationPolicy*>(this)->peerUri,
-        static_cast<CommunicationPolicy*>(this)->ctrlUri);
+    if (bootstrapGroupSize > 1) {
+        std::tie(contextID, uris) = bootstrapTree();
+        vAddr = bootstrapRank;
+    } else {
+        // Retrieve Context id for initial context from signaling process
+        contextID = getContextID(contextName);
+
+        // Retrieve own vAddr from signaling process for initial context
+        vAddr = getVAddr(
+            contextID,
+            static_cast<CommunicationPolicy*>(this)->peerUri,
+            static_cast<CommunicationPolicy*>(this)->ctrlUri);
+        checkVAddr(vAddr, contextName, contextSize);
+
+        // Retrieve for uris of other peers from signaling process for the initial context
+        uris = getUris(contextID, contextSize);
+    }
+
+    contextNames[contextID] = contextName;
     initialContext = Context(contextID, vAddr, contextSize);
-    contexts[initialContext.getID()] = initialContext;
+    {
+        std::lock_guard<std::mutex> lock(contextMtx);
+        contexts[initialContext.getID()] = initialContext;
+    }
 
-    // Retrieve for uris of other peers from signaling process for the initial context
     for (auto const& vAddr : initialContext) {
         Uri remoteUri;
         Uri ctrlUri;
-        std::tie(remoteUri, ctrlUri) = getUri(initialContext.getID(), vAddr);
+        std::tie(remoteUri, ctrlUri) = uris.at(vAddr);
         phoneBook[initialContext.getID()][vAddr] = remoteUri;
         ctrlPhoneBook[initialContext.getID()][vAddr] = ctrlUri;
         inversePhoneBook[initialContext.getID()][remoteUri] = vAddr;
         inverseCtrlPhoneBook[initialContext.getID()][ctrlUri] = vAddr;
     }
 
-    // Create socket connection to other peers
-    // Create socketmapping from initial context to sockets of VAddrs
-    static_cast<CommunicationPolicy*>(this)->createSocketsToPeers();
-
+    // Create socketmapping from initial context to sockets of VAddrs,
+    // sockets are connected on the first send to a peer
     for (auto const& vAddr : initialContext) {
         sendSocketMappings[initialContext.getID()][vAddr] = vAddr;
-        static_cast<CommunicationPolicy*>(this)->connectToSocket(
-            static_cast<CommunicationPolicy*>(this)->sendSockets.at(
-                sendSocketMappings.at(initialContext.getID()).at(vAddr)),
-            phoneBook.at(initialContext.getID()).at(vAddr).c_str());
-        static_cast<CommunicationPolicy*>(this)->connectToSocket(
-            static_cast<CommunicationPolicy*>(this)->ctrlSendSockets.at(
-                sendSocketMappings.at(initialContext.getID()).at(vAddr)),
-            ctrlPhoneBook.at(initialContext.getID()).at(vAddr).c_str());
-
-        // std::cout << "sendSocket_i: " << vAddr << " --> " <<
-        // phoneBook.at(initialContext.getID()).at(vAddr) << std::endl;
+        sendUris.push_back(phoneBook.at(initialContext.getID()).at(vAddr));
+        ctrlSendUris.push_back(ctrlPhoneBook.at(initialContext.getID()).at(vAddr));
     }
+    nUnconfirmed = std::vector<std::atomic<unsigned>>(contextSize);
+    lastSendConfirmable.assign(contextSize, true);
+    batches.resize(contextSize);
 
     // Create thread which recv all messages to this peer
+    if (nRecvWorkers > 0) {
+        recvWork.reset(new boost::asio::io_service::work(recvService));
+        for (std::size_t worker_i = 0; worker_i < nRecvWorkers; ++worker_i) {
+            recvStrands.emplace_back(new boost::asio::io_service::strand(recvService));
+            recvWorkers.emplace_back([this]() { recvService.run(); });
+        }
+    }
     recvHandler = std::thread(&Base<CommunicationPolicy>::handleRecv, this);
+
+    if (batchSize > 0) {
+        batchFlusher = std::thread(&Base<CommunicationPolicy>::handleBatches, this);
+    }
+    if (rendezvousThreshold > 0) {
+        rendezvousSender = std::thread(&Base<CommunicationPolicy>::handleRendezvous, this);
+    }
     ctrlHandler = std::thread(&Base<CommunicationPolicy>::handleCtrl, this);
 
     // std::cout << "<-- init" << std::endl;
@@ -348,11 +664,39 @@ template <typename T_CommunicationPolicy> auto Base<T_CommunicationPolicy>::init
 
 template <typename T_CommunicationPolicy> auto Base<T_CommunicationPolicy>::deinit() -> void
 {
-    // Leave context
-    LeaveRequest request;
-    LeaveReply reply;
-    request.set_context_name(contextName);
-    signalingClient_.LeaveContext(request, &reply);
+    // Leave context, in a tree bootstrap only leaders requested the
+    // initial context and registered in '<name>/leaders'
+    if (isBootstrapLeader()) {
+        std::vector<ContextName> names{ contextName };
+        if (bootstrapGroupSize > 1) {
+            names.push_back(contextName + "/leaders");
+        }
+
+        for (auto const& name : names) {
+            signaling_->leaveContext(name);
+        }
+    }
+
+    // Send what is left of cleared rendezvous payloads
+    if (rendezvousSender.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(rendezvousMtx);
+            stopRendezvousSender = true;
+        }
+        rendezvousSenderWakeup.notify_one();
+        rendezvousSender.join();
+    }
+
+    // Send what is left in the batches
+    if (batchFlusher.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(sendMtx);
+            stopBatchFlusher = true;
+        }
+        batchFlusherWakeup.notify_one();
+        batchFlusher.join();
+    }
+    static_cast<CommunicationPolicy*>(this)->flush();
 
     // shutdown worker threads
     std::array<unsigned, 1> null;
@@ -360,6 +704,12 @@ template <typename T_CommunicationPolicy> auto Base<T_CommunicationPolicy>::dein
         MsgType::DESTRUCT, 0, initialContext, initialContext.getVAddr(), 0, null);
     recvHandler.join();
     ctrlHandler.join();
+
+    // Workers finish the messages passed on before the destruct message
+    recvWork.reset();
+    for (auto& worker : recvWorkers) {
+        worker.join();
+    }
 }
 
 template <typename T_CommunicationPolicy>
@@ -374,6 +724,9 @@ auto Base<T_CommunicationPolicy>::send(
     using Event = graybat::communicationPolicy::Event<CommunicationPolicy>;
 
     Event e = asyncSend(destVAddr, tag, context, sendData);
+
+    // Otherwise a batched message waits for the batch timeout
+    static_cast<CommunicationPolicy*>(this)->flush();
     e.wait();
 }
 
@@ -398,6 +751,52 @@ auto Base<T_CommunicationPolicy>::asyncSend(
     return Event(msgID, context, destVAddr, tag, *static_cast<CommunicationPolicy*>(this));
 }
 
+template <typename T_CommunicationPolicy>
+template <typename T_Send>
+auto Base<T_CommunicationPolicy>::asyncMulticast(
+    const VAddr destVAddr,
+    const std::vector<Tag>& tags,
+    const Context context,
+    const T_Send& sendData,
+    std::vector<Event>& events) -> void
+{
+    const std::size_t dataSize = sizeof(typename T_Send::value_type) * sendData.size();
+    if (tags.size() < 2 || (rendezvousThreshold > 0 && dataSize >= rendezvousThreshold)) {
+        for (Tag const tag : tags) {
+            events.push_back(asyncSend(destVAddr, tag, context, sendData));
+        }
+        return;
+    }
+
+    // The payload starts with the number of tags and the tags, all
+    // tags are confirmed with the same msg id
+    const MsgID msgID = getMsgID();
+    const std::uint32_t nTags = tags.size();
+    const std::size_t prefixSize = sizeof(nTags) + nTags * sizeof(std::uint32_t);
+
+    Message message(
+        MsgType::MULTICAST,
+        msgID,
+        context.getID(),
+        context.getVAddr(),
+        tags.front(),
+        prefixSize + dataSize);
+    std::int8_t* payload = message.getData();
+    memcpy(payload, &nTags, sizeof(nTags));
+    for (std::size_t tag_i = 0; tag_i < nTags; ++tag_i) {
+        const std::uint32_t tag = tags[tag_i];
+        memcpy(payload + sizeof(nTags) + tag_i * sizeof(tag), &tag, sizeof(tag));
+    }
+    memcpy(payload + prefixSize, sendData.data(), dataSize);
+
+    postMessage(context, destVAddr, message);
+
+    for (Tag const tag : tags) {
+        events.push_back(
+            Event(msgID, context, destVAddr, tag, *static_cast<CommunicationPolicy*>(this)));
+    }
+}
+
 template <typename T_CommunicationPolicy>
 template <typename T_Recv>
 auto Base<T_CommunicationPolicy>::recv(
@@ -490,109 +889,90 @@ auto Base<T_CommunicationPolicy>::splitContext(
     using CommunicationPolicy = T_CommunicationPolicy;
     using Context = graybat::communicationPolicy::Context<CommunicationPolicy>;
 
-    // std::cout  << oldContext.getVAddr() << " splitcontext entry" << std::endl;
-
-    Context newContext;
-    VAddr masterVAddr = 0;
+    const VAddr myVAddr = oldContext.getVAddr();
+    const unsigned nPeers = oldContext.size();
 
-    // Request old master for new context
-    std::array<unsigned, 1> member{ { isMember } };
-    static_cast<CommunicationPolicy*>(this)->asyncSendImpl(
-        MsgType::SPLIT, getMsgID(), oldContext, masterVAddr, 0, member);
-
-    // Peer with VAddr 0 collects new members
-    if (oldContext.getVAddr() == masterVAddr) {
-        std::array<ContextID, 1> newContextID{ { 0 } };
-        std::array<unsigned, 1> newContextSize{ { 0 } };
-        std::vector<VAddr> newContextWhiteList(0, 0);
-
-        for (auto const& vAddr : oldContext) {
-            std::array<unsigned, 1> remoteIsMember{ { 0 } };
-            // std::cout << "Recv remoteIsMember: " <<  vAddr << std::endl;
-            static_cast<CommunicationPolicy*>(this)->recvImpl(
-                MsgType::SPLIT, oldContext, vAddr, 0, remoteIsMember);
-
-            if (remoteIsMember[0]) {
-                newContextWhiteList.push_back(vAddr);
-            }
-        }
+    // Allgather of member flag and next split id (Bruck), flags[2 * i]
+    // and flags[2 * i + 1] belong to peer (myVAddr + i) % nPeers
+    std::vector<unsigned> flags{ isMember, nextSplitID };
+    for (unsigned distance = 1; distance < nPeers; distance *= 2) {
+        const VAddr destVAddr = (myVAddr + nPeers - distance) % nPeers;
+        const VAddr srcVAddr = (myVAddr + distance) % nPeers;
+        std::vector<unsigned> sendFlags(
+            flags.begin(), flags.begin() + 2 * std::min(distance, nPeers - distance));
+        std::vector<unsigned> recvFlags(sendFlags.size());
 
-        ContextName newContextName = contextName + "_" + std::to_string(std::rand());
-        newContextID[0] = getContextID(newContextName);
-        contextNames[newContextID[0]] = newContextName;
-        newContextSize[0] = newContextWhiteList.size();
+        static_cast<CommunicationPolicy*>(this)->asyncSendImpl(
+            MsgType::SPLIT, getMsgID(), oldContext, destVAddr, 0, sendFlags);
+        static_cast<CommunicationPolicy*>(this)->recvImpl(
+            MsgType::SPLIT, oldContext, srcVAddr, 0, recvFlags);
 
-        for (VAddr vAddr : newContextWhiteList) {
-            static_cast<CommunicationPolicy*>(this)->asyncSendImpl(
-                MsgType::SPLIT, getMsgID(), oldContext, vAddr, 0, newContextID);
-            static_cast<CommunicationPolicy*>(this)->asyncSendImpl(
-                MsgType::SPLIT, getMsgID(), oldContext, vAddr, 0, newContextSize);
-            static_cast<CommunicationPolicy*>(this)->asyncSendImpl(
-                MsgType::SPLIT, getMsgID(), oldContext, vAddr, 0, newContextWhiteList);
-        }
+        flags.insert(flags.end(), recvFlags.begin(), recvFlags.end());
     }
 
-    // std::cout << oldContext.getVAddr() << " check 0" << std::endl;
-
-    if (isMember) {
-        std::array<ContextID, 1> newContextID{ { 0 } };
-        std::array<unsigned, 1> newContextSize{ { 0 } };
-
-        static_cast<CommunicationPolicy*>(this)->recvImpl(
-            MsgType::SPLIT, oldContext, 0, 0, newContextID);
-        static_cast<CommunicationPolicy*>(this)->recvImpl(
-            MsgType::SPLIT, oldContext, 0, 0, newContextSize);
+    unsigned splitID = 0;
+    for (unsigned peer_i = 0; peer_i < nPeers; ++peer_i) {
+        splitID = std::max(splitID, flags[2 * peer_i + 1]);
+    }
+    nextSplitID = splitID + 1;
+    const ContextID newContextID = 2 * splitID + 1;
 
-        std::vector<VAddr> newContextWhiteList(newContextSize[0], 0);
+    if (!isMember) {
+        // Invalid context for "not members"
+        return Context();
+    }
 
-        static_cast<CommunicationPolicy*>(this)->recvImpl(
-            MsgType::SPLIT, oldContext, 0, 0, newContextWhiteList);
+    // Members are numbered in the order of their VAddr in the old context
+    std::vector<VAddr> members;
+    for (auto const& oldVAddr : oldContext) {
+        if (flags[2 * ((oldVAddr + nPeers - myVAddr) % nPeers)]) {
+            members.push_back(oldVAddr);
+        }
+    }
 
-        newContext = Context(newContextID[0], oldContext.getVAddr(), newContextWhiteList);
-        contexts[newContext.getID()] = newContext;
+    VAddr newVAddr
+        = std::distance(members.begin(), std::find(members.begin(), members.end(), myVAddr));
+    Context newContext(newContextID, newVAddr, members.size());
+
+    // Update phonebook for new context
+    for (auto const& vAddr : newContext) {
+        Uri remoteUri = phoneBook.at(oldContext.getID()).at(members[vAddr]);
+        Uri ctrlUri = ctrlPhoneBook.at(oldContext.getID()).at(members[vAddr]);
+        phoneBook[newContext.getID()][vAddr] = remoteUri;
+        ctrlPhoneBook[newContext.getID()][vAddr] = ctrlUri;
+        inversePhoneBook[newContext.getID()][remoteUri] = vAddr;
+        inverseCtrlPhoneBook[newContext.getID()][ctrlUri] = vAddr;
+    }
 
-        // std::cout  << oldContext.getVAddr() << " check 1" << std::endl;
-        // Update phonebook for new context
-        for (auto const& vAddr : newContext) {
-            Uri remoteUri = phoneBook[oldContext.getID()][vAddr];
-            Uri ctrlUri = ctrlPhoneBook[oldContext.getID()][vAddr];
-            phoneBook[newContext.getID()][vAddr] = remoteUri;
-            ctrlPhoneBook[newContext.getID()][vAddr] = ctrlUri;
-            inversePhoneBook[newContext.getID()][remoteUri]
-                = inversePhoneBook[oldContext.getID()][remoteUri];
-            inverseCtrlPhoneBook[newContext.getID()][ctrlUri]
-                = inverseCtrlPhoneBook[oldContext.getID()][ctrlUri];
-        }
-
-        // std::cout  << oldContext.getVAddr() << " check 2" << std::endl;
-        // Create mappings to sockets for new context
+    // Create mappings to sockets for new context and confirm
+    // messages that already arrived in the new context
+    std::vector<std::tuple<MsgID, VAddr, Tag>> confirms;
+    {
+        std::lock_guard<std::mutex> lock(contextMtx);
         for (auto const& vAddr : newContext) {
-            Uri uri = phoneBook.at(oldContext.getID()).at(vAddr);
-            VAddr oldVAddr = inversePhoneBook.at(oldContext.getID()).at(uri);
             sendSocketMappings[newContext.getID()][vAddr]
-                = sendSocketMappings.at(oldContext.getID()).at(oldVAddr);
+                = sendSocketMappings.at(oldContext.getID()).at(members[vAddr]);
         }
+        contexts[newContext.getID()] = newContext;
 
-    } else {
-        // Invalid context for "not members"
-        newContext = Context();
+        auto pending = pendingConfirms.find(newContext.getID());
+        if (pending != pendingConfirms.end()) {
+            confirms = std::move(pending->second);
+            pendingConfirms.erase(pending);
+        }
     }
 
-    // std::cout  << oldContext.getVAddr() << " check 3" << std::endl;
-
-    // Barrier thus recvHandler is up to date with sendSocketMappings
-    // Necessary in environment with multiple zmq objects
     std::array<unsigned, 0> null;
-    for (auto const& vAddr : oldContext) {
+    for (auto const& confirm : confirms) {
         static_cast<CommunicationPolicy*>(this)->asyncSendImpl(
-            MsgType::SPLIT, getMsgID(), oldContext, vAddr, 0, null);
-    }
-    for (auto const& vAddr : oldContext) {
-        static_cast<CommunicationPolicy*>(this)->recvImpl(
-            MsgType::SPLIT, oldContext, vAddr, 0, null);
+            MsgType::CONFIRM,
+            std::get<0>(confirm),
+            newContext,
+            std::get<1>(confirm),
+            std::get<2>(confirm),
+            null);
     }
 
-    // std::cout  << oldContext.getVAddr() << " splitContext end" << std::endl;
     return newContext;
 }
 
@@ -600,34 +980,27 @@ template <typename T_CommunicationPolicy>
 auto Base<T_CommunicationPolicy>::getContextID(const ContextName& contextName)
     -> graybat::communicationPolicy::ContextID<T_CommunicationPolicy>
 {
-    // std::cout << "--> getContextID" << std::endl;
-    ContextRequest request;
-    ContextReply reply;
-    request.set_context_name(contextName);
-
-    signalingClient_.RequestContext(request, &reply);
-
-    // std::cout << "<-- getContextID" << std::endl;
-    return reply.context_id();
+    return 2 * signaling_->requestContext(contextName);
 }
 
 template <typename T_CommunicationPolicy>
 auto Base<T_CommunicationPolicy>::getVAddr(ContextID contextId, Uri const& uri, Uri const& ctrlUri)
     -> graybat::communicationPolicy::VAddr<T_CommunicationPolicy>
 {
-    // std::cout << "--> getVAddr" << std::endl;
-
-    VaddrRequest request;
-    VaddrReply reply;
-
-    request.set_context_id(contextId);
-    request.set_data_uri(uri);
-    request.set_ctrl_uri(ctrlUri);
-
-    signalingClient_.RequestVaddr(request, &reply);
+    return signaling_->requestVaddr(contextId / 2, uri, ctrlUri);
+}
 
-    // std::cout << "<-- getVAddr" << std::endl;
-    return reply.vaddr();
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::checkVAddr(
+    VAddr vAddr, const ContextName& contextName, std::size_t contextSize) -> void
+{
+    if (vAddr >= contextSize) {
+        std::stringstream errorMsg;
+        errorMsg << "Signaling: vaddr " << vAddr << " of context " << contextName
+                 << " is not below its size " << contextSize
+                 << ", peers of an earlier job are still registered.";
+        throw std::runtime_error(errorMsg.str());
+    }
 }
 
 template <typename T_CommunicationPolicy>
@@ -636,21 +1009,158 @@ auto Base<T_CommunicationPolicy>::getUri(
     graybat::communicationPolicy::VAddr<T_CommunicationPolicy> vAddr) -> std::
     pair<graybat::communicationPolicy::socket::Uri<T_CommunicationPolicy>, graybat::communicationPolicy::socket::Uri<T_CommunicationPolicy>>
 {
-    VaddrLookup request;
-    UriReply reply;
-    request.set_context_id(contextId);
-    request.set_vaddr(vAddr);
+    return signaling_->lookupVaddr(contextId / 2, vAddr);
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::getUris(
+    graybat::communicationPolicy::ContextID<T_CommunicationPolicy> contextId,
+    std::size_t contextSize)
+    -> std::vector<std::pair<graybat::communicationPolicy::socket::Uri<T_CommunicationPolicy>,
+                             graybat::communicationPolicy::socket::Uri<T_CommunicationPolicy>>>
+{
+    return signaling_->lookupContext(contextId / 2, contextSize);
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::bootstrapTree()
+    -> std::pair<graybat::communicationPolicy::ContextID<T_CommunicationPolicy>,
+                 std::vector<std::pair<graybat::communicationPolicy::socket::Uri<T_CommunicationPolicy>,
+                                       graybat::communicationPolicy::socket::Uri<T_CommunicationPolicy>>>>
+{
+    CommunicationPolicy& cp = *static_cast<CommunicationPolicy*>(this);
+
+    const std::size_t k = bootstrapGroupSize;
+    const std::size_t groupBegin = bootstrapRank / k * k;
+    const std::size_t groupEnd = std::min(contextSize, groupBegin + k);
+    const Uri groupUri = "ipc://" + bootstrapDir + "/graybat-" + contextName + "-"
+        + std::to_string(bootstrapRank / k);
+
+    ContextID contextID = 0;
+    std::vector<BootstrapEntry> entries{ BootstrapEntry(bootstrapRank, cp.peerUri, cp.ctrlUri) };
+
+    if (!isBootstrapLeader()) {
+        // Members only talk to their leader
+        Socket leaderSocket = cp.createSendSocket();
+        cp.connectToSocket(leaderSocket, groupUri);
+        sendBootstrap(leaderSocket, BOOTSTRAP_FRAGMENT, contextID, entries);
+        entries = recvBootstrap(BOOTSTRAP_BOOK, contextID);
+
+    } else {
+        cp.bindToSocket(cp.ctrlSocket, groupUri);
+
+        // Leaders find each other through the signaling server
+        const std::size_t nLeaders = (contextSize + k - 1) / k;
+        contextID = getContextID(contextName);
+        const ContextID leaderContextID = getContextID(contextName + "/leaders");
+        const VAddr leader = getVAddr(leaderContextID, cp.peerUri, cp.ctrlUri);
+        checkVAddr(leader, contextName + "/leaders", nLeaders);
+        const std::vector<std::pair<Uri, Uri>> leaderUris = getUris(leaderContextID, nLeaders);
+
+        std::vector<Uri> destUris;
+        for (std::size_t child = leader * k + 1; child <= leader * k + k && child < nLeaders;
+             ++child) {
+            destUris.push_back(leaderUris.at(child).second);
+        }
+
+        // Gather the fragments of the members and of the subtrees of the children
+        const std::size_t nFragments = (groupEnd - groupBegin - 1) + destUris.size();
+        for (std::size_t fragment_i = 0; fragment_i < nFragments; ++fragment_i) {
+            ContextID fragmentContextID = 0;
+            std::vector<BootstrapEntry> fragment
+                = recvBootstrap(BOOTSTRAP_FRAGMENT, fragmentContextID);
+            entries.insert(entries.end(), fragment.begin(), fragment.end());
+        }
+        cp.unbindFromSocket(cp.ctrlSocket, groupUri);
+
+        for (auto const& entry : entries) {
+            const std::size_t rank = std::get<0>(entry);
+            if (rank > groupBegin && rank < groupEnd) {
+                destUris.push_back(std::get<2>(entry));
+            }
+        }
+
+        if (leader != 0) {
+            Socket parentSocket = cp.createSendSocket();
+            cp.connectToSocket(parentSocket, leaderUris.at((leader - 1) / k).second);
+            sendBootstrap(parentSocket, BOOTSTRAP_FRAGMENT, contextID, entries);
+            entries = recvBootstrap(BOOTSTRAP_BOOK, contextID);
+        }
+
+        // Relay the complete phone book down the tree
+        for (auto const& destUri : destUris) {
+            Socket socket = cp.createSendSocket();
+            cp.connectToSocket(socket, destUri);
+            sendBootstrap(socket, BOOTSTRAP_BOOK, contextID, entries);
+        }
+    }
+
+    std::sort(entries.begin(), entries.end());
+
+    std::vector<std::pair<Uri, Uri>> uris;
+    for (auto const& entry : entries) {
+        if (std::get<0>(entry) != uris.size()) {
+            throw std::runtime_error("Tree bootstrap: bootstrap ranks are not 0,...,n-1.");
+        }
+        uris.emplace_back(std::get<1>(entry), std::get<2>(entry));
+    }
+
+    if (uris.size() != contextSize) {
+        throw std::runtime_error("Tree bootstrap: phone book is incomplete.");
+    }
+
+    return std::make_pair(contextID, uris);
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::sendBootstrap(
+    Socket& socket,
+    BootstrapTag const tag,
+    ContextID const contextID,
+    std::vector<BootstrapEntry> const& entries) -> void
+{
+    std::ostringstream payload;
+    for (auto const& entry : entries) {
+        payload << std::get<0>(entry) << " " << std::get<1>(entry) << " " << std::get<2>(entry)
+                << "\n";
+    }
 
-    Uri ctrlUri{ "" };
-    Uri dataUri{ "" };
+    std::string bytes = payload.str();
+    Message message(MsgType::BOOTSTRAP, 0, contextID, bootstrapRank, tag, bytes);
+    static_cast<CommunicationPolicy*>(this)->sendToSocket(socket, message);
+}
 
-    while (dataUri == "") {
-        signalingClient_.LookupVaddr(request, &reply);
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::recvBootstrap(BootstrapTag const tag, ContextID& contextID)
+    -> std::vector<BootstrapEntry>
+{
+    // The ctrl handler is not running yet, thus the ctrl socket is free to use
+    Message message;
+    static_cast<CommunicationPolicy*>(this)->recvFromSocket(
+        static_cast<CommunicationPolicy*>(this)->ctrlSocket, message);
 
-        dataUri = reply.data_uri();
-        ctrlUri = reply.ctrl_uri();
+    if (message.getMsgType() != MsgType::BOOTSTRAP || message.getTag() != tag) {
+        throw std::runtime_error("Tree bootstrap: received unexpected message.");
     }
-    return std::make_pair(dataUri, ctrlUri);
+    contextID = message.getContextID();
+
+    std::istringstream payload(std::string(
+        reinterpret_cast<char*>(message.getData()), message.size()));
+
+    std::vector<BootstrapEntry> entries;
+    VAddr rank;
+    Uri dataUri;
+    Uri ctrlUri;
+    while (payload >> rank >> dataUri >> ctrlUri) {
+        entries.emplace_back(rank, dataUri, ctrlUri);
+    }
+    return entries;
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::isBootstrapLeader() const -> bool
+{
+    return bootstrapGroupSize < 2 || bootstrapRank % bootstrapGroupSize == 0;
 }
 
 template <typename T_CommunicationPolicy>
@@ -670,30 +1180,375 @@ auto Base<T_CommunicationPolicy>::asyncSendImpl(
     // context.getID() << " " << destVAddr << "(socket_i " <<
     // sendSocketMappings.at(context.getID()).at(destVAddr)<< ") " << tag << std::endl;
 
-    // Create message
+    const std::uint64_t dataSize = sizeof(typename T_Send::value_type) * sendData.size();
+    if (msgType == MsgType::PEER && rendezvousThreshold > 0 && dataSize >= rendezvousThreshold) {
+        {
+            std::lock_guard<std::mutex> lock(rendezvousMtx);
+            rendezvousSends.emplace(
+                RendezvousKey(context.getID(), destVAddr, msgID),
+                RendezvousSend{ context,
+                                tag,
+                                reinterpret_cast<const std::int8_t*>(sendData.data()),
+                                dataSize,
+                                0,
+                                0 });
+        }
+
+        // Confirmed when the payload arrived
+        std::array<std::uint64_t, 1> requestToSend{ { dataSize } };
+        static_cast<CommunicationPolicy*>(this)->asyncSendImpl(
+            MsgType::REQUEST_TO_SEND, msgID, context, destVAddr, tag, requestToSend);
+        return;
+    }
+
     Message message(msgType, msgID, context.getID(), context.getVAddr(), tag, sendData);
+    postMessage(context, destVAddr, message);
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::postMessage(
+    Context const context, VAddr const destVAddr, Message& message) -> void
+{
+    const MsgType msgType = message.getMsgType();
 
-    std::size_t sendSocket_i = sendSocketMappings.at(context.getID()).at(destVAddr);
-    Socket& sendSocket = static_cast<CommunicationPolicy*>(this)->sendSockets.at(sendSocket_i);
-    Socket& ctrlSendSocket
-        = static_cast<CommunicationPolicy*>(this)->ctrlSendSockets.at(sendSocket_i);
+    std::size_t sendSocket_i = 0;
+    {
+        std::lock_guard<std::mutex> lock(contextMtx);
+        sendSocket_i = sendSocketMappings.at(context.getID()).at(destVAddr);
+    }
+
+    if (msgType == MsgType::CONFIRM || msgType == MsgType::CLEAR_TO_SEND) {
+        std::lock_guard<std::mutex> ctrlLock(ctrlSendMtx);
+        static_cast<CommunicationPolicy*>(this)->sendToSocket(
+            getCtrlSendSocket(sendSocket_i), message);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(sendMtx);
+    if (msgType == MsgType::DESTRUCT) {
+        flushBatch(sendSocket_i);
+        std::array<unsigned, 0> null;
+        Message message2(
+            msgType,
+            message.getMsgID(),
+            context.getID(),
+            context.getVAddr(),
+            message.getTag(),
+            null);
+        static_cast<CommunicationPolicy*>(this)->sendToSocket(getSendSocket(sendSocket_i), message);
+
+        std::lock_guard<std::mutex> ctrlLock(ctrlSendMtx);
+        static_cast<CommunicationPolicy*>(this)->sendToSocket(
+            getCtrlSendSocket(sendSocket_i), message2);
 
-    sendMtx.lock();
-    if (msgType == MsgType::CONFIRM) {
-        static_cast<CommunicationPolicy*>(this)->sendToSocket(ctrlSendSocket, message.getMessage());
     } else {
+        // A multicast is confirmed once per tag
+        std::uint32_t nConfirms = 0;
+        if (msgType == MsgType::PEER || msgType == MsgType::REQUEST_TO_SEND) {
+            nConfirms = 1;
+        } else if (msgType == MsgType::MULTICAST) {
+            memcpy(&nConfirms, message.getData(), sizeof(nConfirms));
+        }
+        nUnconfirmed[sendSocket_i] += nConfirms;
+        lastSendConfirmable[sendSocket_i] = nConfirms > 0;
+
+        if (batchSize > 0 && (msgType == MsgType::PEER || msgType == MsgType::MULTICAST)) {
+            appendToBatch(sendSocket_i, message);
+        } else {
+            // Keep the order of batched and not batched messages
+            flushBatch(sendSocket_i);
+            static_cast<CommunicationPolicy*>(this)->sendToSocket(
+                getSendSocket(sendSocket_i), message);
+        }
+    }
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::clearToSend(
+    ContextID const contextID, VAddr const vAddr, MsgID const msgID) -> void
+{
+    const RendezvousKey key(contextID, vAddr, msgID);
+    {
+        std::lock_guard<std::mutex> lock(rendezvousMtx);
+        if (rendezvousSends.find(key) == rendezvousSends.end()) {
+            throw std::runtime_error("Clear to send for an unknown rendezvous message.");
+        }
+        clearedSends.push_back(key);
+    }
+    rendezvousSenderWakeup.notify_one();
+}
 
-        if (msgType == MsgType::DESTRUCT) {
-            Message message2(msgType, msgID, context.getID(), context.getVAddr(), tag, sendData);
-            static_cast<CommunicationPolicy*>(this)->sendToSocket(sendSocket, message.getMessage());
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::handleRendezvous() -> void
+{
+    std::unique_lock<std::mutex> lock(rendezvousMtx);
+
+    while (true) {
+        rendezvousSenderWakeup.wait(
+            lock, [this]() { return stopRendezvousSender || !clearedSends.empty(); });
+        if (clearedSends.empty()) {
+            return;
+        }
+
+        const RendezvousKey key = clearedSends.front();
+        clearedSends.pop_front();
+
+        // Only this thread erases sends, thus the reference stays valid
+        RendezvousSend& send = rendezvousSends.at(key);
+        lock.unlock();
+
+        // Segments start with their offset into the payload, without a
+        // chunk size the payload is split evenly over the rails
+        const std::uint64_t offset = send.sent;
+        const std::size_t remaining = send.size - send.sent;
+        const std::size_t maxSegmentSize
+            = chunkSize > 0 ? chunkSize : (send.size + nRails - 1) / nRails;
+        const std::size_t segmentSize = std::min<std::size_t>(maxSegmentSize, remaining);
+        const std::size_t rail = send.rail++ % nRails;
+
+        Message message(
+            MsgType::RENDEZVOUS,
+            std::get<2>(key),
+            send.context.getID(),
+            send.context.getVAddr(),
+            send.tag,
+            sizeof(offset) + segmentSize);
+        memcpy(message.getData(), &offset, sizeof(offset));
+        memcpy(message.getData() + sizeof(offset), send.data + offset, segmentSize);
+
+        std::size_t sendSocket_i = 0;
+        {
+            std::lock_guard<std::mutex> contextLock(contextMtx);
+            sendSocket_i = sendSocketMappings.at(std::get<0>(key)).at(std::get<1>(key));
+        }
+
+        // Segments are matched by msg id and offset, thus no need to flush
+        // the batch first nor to keep their order across rails. Other
+        // messages get through between two segments.
+        {
+            std::lock_guard<std::mutex> sendLock(sendMtx);
             static_cast<CommunicationPolicy*>(this)->sendToSocket(
-                ctrlSendSocket, message2.getMessage());
+                getRailSendSocket(sendSocket_i, rail), message);
+        }
+        send.sent += segmentSize;
 
+        lock.lock();
+        if (send.sent < send.size) {
+            clearedSends.push_back(key);
         } else {
-            static_cast<CommunicationPolicy*>(this)->sendToSocket(sendSocket, message.getMessage());
+            rendezvousSends.erase(key);
         }
     }
-    sendMtx.unlock();
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::recvSegment(Message& message) -> bool
+{
+    std::uint64_t offset = 0;
+    memcpy(&offset, message.getData(), sizeof(offset));
+    const std::size_t segmentSize = message.size() - sizeof(offset);
+
+    // Buffers are only erased by the last segment, which is processed
+    // after all other segments of the same source
+    PostedRecv* posted = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(rendezvousMtx);
+        auto it = postedRecvs.find(
+            RendezvousKey(message.getContextID(), message.getVAddr(), message.getMsgID()));
+        if (it == postedRecvs.end()) {
+            throw std::runtime_error("Received rendezvous message without posted buffer.");
+        }
+        posted = &it->second;
+    }
+
+    if (offset < posted->size) {
+        memcpy(
+            posted->data + offset,
+            message.getData() + sizeof(offset),
+            std::min<std::size_t>(segmentSize, posted->size - offset));
+    }
+
+    posted->received += segmentSize;
+    if (posted->received < posted->expected) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(rendezvousMtx);
+    posted->done.set_value();
+    postedRecvs.erase(
+        RendezvousKey(message.getContextID(), message.getVAddr(), message.getMsgID()));
+    return true;
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::copyPayload(
+    Message& message, Context const context, void* recvData, size_t const size) -> void
+{
+    if (message.getMsgType() != MsgType::REQUEST_TO_SEND) {
+        memcpy(recvData, static_cast<std::int8_t*>(message.getData()), size);
+        return;
+    }
+
+    std::future<void> done;
+    {
+        std::lock_guard<std::mutex> lock(rendezvousMtx);
+        PostedRecv& posted = postedRecvs[RendezvousKey(
+            message.getContextID(), message.getVAddr(), message.getMsgID())];
+        posted.data = static_cast<std::int8_t*>(recvData);
+        posted.size = size;
+        posted.expected = message.getDataSize();
+        posted.received = 0;
+        done = posted.done.get_future();
+    }
+
+    std::array<unsigned, 0> null;
+    static_cast<CommunicationPolicy*>(this)->asyncSendImpl(
+        MsgType::CLEAR_TO_SEND,
+        message.getMsgID(),
+        context,
+        message.getVAddr(),
+        message.getTag(),
+        null);
+    done.get();
+}
+
+template <typename T_CommunicationPolicy> auto Base<T_CommunicationPolicy>::flush() -> void
+{
+    std::lock_guard<std::mutex> lock(sendMtx);
+    static_cast<CommunicationPolicy*>(this)->beginBatchSends();
+    for (std::size_t sendSocket_i = 0; sendSocket_i < batches.size(); ++sendSocket_i) {
+        flushBatch(sendSocket_i);
+    }
+    static_cast<CommunicationPolicy*>(this)->endBatchSends();
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::appendToBatch(std::size_t const sendSocket_i, Message& message)
+    -> void
+{
+    Batch& batch = batches[sendSocket_i];
+    const std::uint32_t frameSize = message.getFrameSize();
+
+    if (batch.frames.size() + sizeof(frameSize) + frameSize > batchSize) {
+        flushBatch(sendSocket_i);
+    }
+
+    // Too large for a batch anyway
+    if (sizeof(frameSize) + frameSize > batchSize) {
+        static_cast<CommunicationPolicy*>(this)->sendToSocket(getSendSocket(sendSocket_i), message);
+        return;
+    }
+
+    if (batch.frames.empty()) {
+        batch.since = std::chrono::steady_clock::now();
+    }
+
+    // Header and payload are apart when the payload is borrowed
+    const std::int8_t* size = reinterpret_cast<const std::int8_t*>(&frameSize);
+    const std::size_t headerSize = frameSize - message.size();
+    batch.frames.insert(batch.frames.end(), size, size + sizeof(frameSize));
+    batch.frames.insert(batch.frames.end(), message.getFrame(), message.getFrame() + headerSize);
+    batch.frames.insert(batch.frames.end(), message.getData(), message.getData() + message.size());
+
+    // Flush when not even an empty message fits anymore
+    if (batch.frames.size() + sizeof(frameSize) + WireHeader::minSize > batchSize) {
+        flushBatch(sendSocket_i);
+    }
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::flushBatch(std::size_t const sendSocket_i) -> void
+{
+    Batch& batch = batches[sendSocket_i];
+    if (batch.frames.empty()) {
+        return;
+    }
+
+    Message message(MsgType::BATCH, 0, 0, 0, 0, batch.frames);
+    static_cast<CommunicationPolicy*>(this)->sendBatchToSocket(
+        getSendSocket(sendSocket_i), message, batch.frames);
+    batch.frames.clear();
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::sendBatchToSocket(
+    Socket& socket, Message& batch, std::vector<std::int8_t>&) -> void
+{
+    static_cast<CommunicationPolicy*>(this)->sendToSocket(socket, batch);
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::handleBatches() -> void
+{
+    std::unique_lock<std::mutex> lock(sendMtx);
+    while (!stopBatchFlusher) {
+        batchFlusherWakeup.wait_for(lock, batchTimeout);
+
+        const auto expired = std::chrono::steady_clock::now() - batchTimeout;
+        static_cast<CommunicationPolicy*>(this)->beginBatchSends();
+        for (std::size_t sendSocket_i = 0; sendSocket_i < batches.size(); ++sendSocket_i) {
+            if (!batches[sendSocket_i].frames.empty() && batches[sendSocket_i].since <= expired) {
+                flushBatch(sendSocket_i);
+            }
+        }
+        static_cast<CommunicationPolicy*>(this)->endBatchSends();
+    }
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::getSendSocket(std::size_t const sendSocket_i) -> Socket&
+{
+    CommunicationPolicy& cp = *static_cast<CommunicationPolicy*>(this);
+
+    return cp.sendSockets.get(
+        sendSocket_i,
+        [this, &cp](std::size_t socket_i) {
+            Socket socket = cp.createSendSocket();
+            cp.connectToSocket(socket, sendUris.at(socket_i));
+            return socket;
+        },
+        [this](std::size_t socket_i) {
+            return lastSendConfirmable[socket_i] && nUnconfirmed[socket_i] == 0;
+        });
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::getRailSendSocket(
+    std::size_t const sendSocket_i, std::size_t const rail) -> Socket&
+{
+    if (rail == 0) {
+        return getSendSocket(sendSocket_i);
+    }
+
+    CommunicationPolicy& cp = *static_cast<CommunicationPolicy*>(this);
+
+    // Rails only carry rendezvous segments, which may overtake each
+    // other anyway, thus all are evictable
+    return cp.railSendSockets.get(
+        sendSocket_i * (nRails - 1) + rail - 1,
+        [this, &cp, sendSocket_i](std::size_t) {
+            Socket socket = cp.createSendSocket();
+            cp.connectToSocket(socket, sendUris.at(sendSocket_i));
+            return socket;
+        },
+        [](std::size_t) { return true; });
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::getCtrlSendSocket(std::size_t const sendSocket_i) -> Socket&
+{
+    CommunicationPolicy& cp = *static_cast<CommunicationPolicy*>(this);
+
+    // Confirmations are matched by their message id, thus
+    // overtaking confirmations are fine and all are evictable
+    return cp.ctrlSendSockets.get(
+        sendSocket_i,
+        [this, &cp](std::size_t socket_i) {
+            Socket socket = cp.createSendSocket();
+            cp.connectToSocket(socket, ctrlSendUris.at(socket_i));
+            return socket;
+        },
+        [](std::size_t) { return true; });
 }
 
 template <typename T_CommunicationPolicy>
@@ -709,9 +1564,10 @@ auto Base<T_CommunicationPolicy>::recvImpl(
     using Message = graybat::communicationPolicy::socket::Message<T_CommunicationPolicy>;
 
     Message message(std::move(inBox.waitDequeue(msgType, context.getID(), srcVAddr, tag)));
-    memcpy(
+    copyPayload(
+        message,
+        context,
         static_cast<void*>(recvData.data()),
-        static_cast<std::int8_t*>(message.getData()),
         sizeof(typename T_Recv::value_type) * recvData.size());
 }
 
@@ -734,9 +1590,10 @@ auto Base<T_CommunicationPolicy>::recvImpl(
     destVAddr = hana::at(keys, hana::size_c<2>);
     tag = hana::at(keys, hana::size_c<3>);
 
-    memcpy(
+    copyPayload(
+        message,
+        context,
         static_cast<void*>(recvData.data()),
-        static_cast<std::int8_t*>(message.getData()),
         sizeof(typename T_Recv::value_type) * recvData.size());
 
     return Event(getMsgID(), context, destVAddr, tag, *(static_cast<CommunicationPolicy*>(this)));
@@ -756,9 +1613,10 @@ auto Base<T_CommunicationPolicy>::asyncRecvImpl(
     bool result = false;
     Message message = std::move(inBox.tryDequeue(result, msgType, context.getID(), srcVAddr, tag));
     if (result) {
-        memcpy(
+        copyPayload(
+            message,
+            context,
             static_cast<void*>(recvData.data()),
-            static_cast<std::int8_t*>(message.getData()),
             sizeof(typename T_Recv::value_type) * recvData.size());
         return true;
     }
@@ -783,7 +1641,7 @@ auto Base<T_CommunicationPolicy>::asyncRecvImpl(
         // std::cout << "Copy data: " << "bytes: " << size << " " << "0: " <<
         // reinterpret_cast<unsigned*>(message.getData())[0] << " 1: " <<
         // reinterpret_cast<unsigned*>(message.getData())[1]<< std::endl;
-        memcpy(recvData, static_cast<std::int8_t*>(message.getData()), size);
+        copyPayload(message, context, recvData, size);
         return true;
     } else {
         // std::cout << "No message received" << std::endl;
@@ -818,24 +1676,110 @@ template <typename T_CommunicationPolicy> auto Base<T_CommunicationPolicy>::hand
             return;
         }
 
-        if (message.getMsgType() == MsgType::PEER) {
-            std::array<unsigned, 0> null;
-            Context context = contexts.at(message.getContextID());
-            static_cast<CommunicationPolicy*>(this)->asyncSendImpl(
-                MsgType::CONFIRM,
+        if (message.getMsgType() == MsgType::BATCH) {
+            // Split into the batched messages, each prefixed by its size
+            const std::int8_t* frames = message.getData();
+            const std::size_t size = message.size();
+            for (std::size_t offset = 0; offset < size;) {
+                std::uint32_t frameSize = 0;
+                std::memcpy(&frameSize, frames + offset, sizeof(frameSize));
+                offset += sizeof(frameSize);
+
+                Message batchedMessage(frames + offset, frameSize);
+                offset += frameSize;
+                dispatchRecv(batchedMessage);
+            }
+        } else {
+            dispatchRecv(message);
+        }
+    }
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::dispatchRecv(Message& message) -> void
+{
+    if (recvStrands.empty()) {
+        processRecv(message);
+    } else {
+        const std::size_t strand_i
+            = (message.getContextID() * 0x9E3779B9u + message.getVAddr()) % recvStrands.size();
+        std::shared_ptr<Message> sharedMessage = std::make_shared<Message>(std::move(message));
+        recvStrands[strand_i]->post([this, sharedMessage]() { processRecv(*sharedMessage); });
+    }
+}
+
+template <typename T_CommunicationPolicy>
+auto Base<T_CommunicationPolicy>::processRecv(Message& message) -> void
+{
+    using CommunicationPolicy = T_CommunicationPolicy;
+
+    const MsgType msgType = message.getMsgType();
+
+    // Fan out into a peer message per tag
+    if (msgType == MsgType::MULTICAST) {
+        std::uint32_t nTags = 0;
+        memcpy(&nTags, message.getData(), sizeof(nTags));
+        const std::size_t prefixSize = sizeof(nTags) + nTags * sizeof(std::uint32_t);
+        const std::size_t dataSize = message.size() - prefixSize;
+
+        for (std::size_t tag_i = 0; tag_i < nTags; ++tag_i) {
+            std::uint32_t tag = 0;
+            memcpy(&tag, message.getData() + sizeof(nTags) + tag_i * sizeof(tag), sizeof(tag));
+
+            Message peerMessage(
+                MsgType::PEER,
                 message.getMsgID(),
-                context,
+                message.getContextID(),
                 message.getVAddr(),
-                message.getTag(),
-                null);
+                tag,
+                dataSize);
+            memcpy(peerMessage.getData(), message.getData() + prefixSize, dataSize);
+            processRecv(peerMessage);
         }
+        return;
+    }
 
+    if (msgType == MsgType::RENDEZVOUS && !recvSegment(message)) {
+        return;
+    }
+
+    const MsgID msgID = message.getMsgID();
+    const ContextID contextID = message.getContextID();
+    const VAddr vAddr = message.getVAddr();
+    const Tag tag = message.getTag();
+
+    // A request to send waits in the inBox in place of its payload,
+    // thus keeps its order to other peer messages
+    if (msgType != MsgType::RENDEZVOUS) {
         inBox.enqueue(
             std::move(message),
-            message.getMsgType(),
-            message.getContextID(),
-            message.getVAddr(),
-            message.getTag());
+            msgType == MsgType::REQUEST_TO_SEND ? MsgType::PEER : msgType,
+            contextID,
+            vAddr,
+            tag);
+    }
+
+    // Requests to send are confirmed when their payload arrived. The
+    // confirm follows the enqueue, thus a ready send is also a
+    // received one.
+    if (msgType == MsgType::PEER || msgType == MsgType::RENDEZVOUS) {
+        std::array<unsigned, 0> null;
+        Context context;
+        {
+            std::lock_guard<std::mutex> lock(contextMtx);
+            auto it = contexts.find(contextID);
+            if (it != contexts.end()) {
+                context = it->second;
+            } else {
+                // Sender finished splitContext before this peer
+                pendingConfirms[contextID].emplace_back(msgID, vAddr, tag);
+            }
+        }
+
+        if (context.valid()) {
+            static_cast<CommunicationPolicy*>(this)->asyncSendImpl(
+                MsgType::CONFIRM, msgID, context, vAddr, tag, null);
+        }
     }
 }
 
@@ -860,15 +1804,22 @@ template <typename T_CommunicationPolicy> auto Base<T_CommunicationPolicy>::hand
         }
 
         if (message.getMsgType() == MsgType::CONFIRM) {
+            {
+                std::lock_guard<std::mutex> lock(contextMtx);
+                nUnconfirmed[sendSocketMappings.at(message.getContextID()).at(message.getVAddr())]--;
+            }
             ctrlBox.enqueue(
                 std::move(message),
                 message.getMsgType(),
                 message.getContextID(),
                 message.getVAddr(),
                 message.getTag());
+        } else if (message.getMsgType() == MsgType::CLEAR_TO_SEND) {
+            clearToSend(message.getContextID(), message.getVAddr(), message.getMsgID());
         } else {
             // Throw exception
-            throw std::runtime_error("Received wrong message type on ctrl socket (not confirm).");
+            throw std::runtime_error(
+                "Received wrong message type on ctrl socket (not confirm or clear to send).");
         }
     }
 }
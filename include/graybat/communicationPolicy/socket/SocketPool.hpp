@@ -0,0 +1,109 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Stl
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace graybat {
+
+namespace communicationPolicy {
+
+namespace socket {
+
+/**
+ * @brief Send sockets to peers, connected on first use and kept in
+ *        least recently used order.
+ *
+ * When the pool is full, the least recently used socket which is
+ * evictable is closed before a new one is connected. The capacity
+ * is soft, the pool grows beyond it when no socket is evictable.
+ * A capacity of 0 never evicts. The pool is not thread safe.
+ */
+template <typename T_Socket> class SocketPool {
+  public:
+    explicit SocketPool(std::size_t capacity)
+        : capacity_(capacity)
+    {
+    }
+
+    /**
+     * @brief Returns the socket to *peer*, connects it by *connect(peer)*
+     *        when it is not pooled. Sockets of peers with
+     *        *evictable(peer)* may be closed to stay within the capacity.
+     *
+     * References stay valid until the next call of get.
+     */
+    template <typename T_Connect, typename T_Evictable>
+    T_Socket& get(std::size_t peer, T_Connect connect, T_Evictable evictable)
+    {
+        auto it = sockets_.find(peer);
+        if (it != sockets_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second.lruPos);
+            return it->second.socket;
+        }
+
+        if (capacity_ != 0 && sockets_.size() >= capacity_) {
+            for (auto lruIt = lru_.rbegin(); lruIt != lru_.rend(); ++lruIt) {
+                if (evictable(*lruIt)) {
+                    sockets_.erase(*lruIt);
+                    lru_.erase(std::next(lruIt).base());
+                    break;
+                }
+            }
+        }
+
+        T_Socket socket = connect(peer);
+        lru_.push_front(peer);
+        Entry& entry
+            = sockets_.emplace(peer, Entry{ std::move(socket), lru_.begin() }).first->second;
+        return entry.socket;
+    }
+
+    std::size_t size() const
+    {
+        return sockets_.size();
+    }
+
+  private:
+    using Lru = std::list<std::size_t>;
+
+    struct Entry {
+        T_Socket socket;
+        Lru::iterator lruPos;
+    };
+
+    const std::size_t capacity_;
+
+    // Most recently used peer first
+    Lru lru_;
+    std::unordered_map<std::size_t, Entry> sockets_;
+};
+
+} // namespace socket
+
+} // namespace communicationPolicy
+
+} // namespace graybat
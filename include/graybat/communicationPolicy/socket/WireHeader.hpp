@@ -0,0 +1,176 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// Stl
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+// Graybat
+#include <graybat/communicationPolicy/Traits.hpp>
+
+namespace graybat {
+
+namespace communicationPolicy {
+
+namespace socket {
+
+/**
+ * @brief Header in front of every message of the socket policies.
+ *
+ * The first byte holds the protocol version (upper two bits),
+ * whether a message id follows (bit five) and the message type
+ * (lower five bits). Message id, context id, vaddr and tag follow
+ * as LEB128 varints, thus small values take a single byte. Only
+ * messages which are matched by their message id carry it.
+ */
+struct WireHeader {
+
+    static constexpr std::uint8_t version = 1;
+    static constexpr std::size_t minSize = 4;
+    static constexpr std::size_t maxSize = 1 + 4 * 5;
+
+    MsgTypeType msgType;
+    unsigned msgID;
+    unsigned contextID;
+    unsigned vAddr;
+    unsigned tag;
+
+    bool hasMsgID() const
+    {
+        switch (msgType) {
+        case MsgTypeType::PEER:
+        case MsgTypeType::CONFIRM:
+        case MsgTypeType::REQUEST_TO_SEND:
+        case MsgTypeType::CLEAR_TO_SEND:
+        case MsgTypeType::RENDEZVOUS:
+        case MsgTypeType::MULTICAST:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    std::size_t encodedSize() const
+    {
+        return 1 + (hasMsgID() ? varintSize(msgID) : 0) + varintSize(contextID)
+            + varintSize(vAddr) + varintSize(tag);
+    }
+
+    /**
+     * @brief Writes the header to *out*, which needs to hold
+     *        encodedSize() bytes.
+     *
+     * @return Number of bytes written
+     */
+    std::size_t encode(std::int8_t* out) const
+    {
+        std::uint8_t* const begin = reinterpret_cast<std::uint8_t*>(out);
+        std::uint8_t* it = begin;
+
+        *it++ = static_cast<std::uint8_t>(
+            (version << 6) | (hasMsgID() ? 0x20 : 0) | (static_cast<std::uint8_t>(msgType) & 0x1f));
+        if (hasMsgID()) {
+            it = encodeVarint(msgID, it);
+        }
+        it = encodeVarint(contextID, it);
+        it = encodeVarint(vAddr, it);
+        it = encodeVarint(tag, it);
+        return it - begin;
+    }
+
+    /**
+     * @brief Reads the header from the first *size* bytes of *in*.
+     *
+     * @return Number of bytes read, the payload starts behind them
+     */
+    std::size_t decode(std::int8_t const* in, std::size_t const size)
+    {
+        std::uint8_t const* const begin = reinterpret_cast<std::uint8_t const*>(in);
+        std::uint8_t const* const end = begin + size;
+        std::uint8_t const* it = begin;
+
+        if (it == end) {
+            throw std::runtime_error("Wire header: empty message.");
+        }
+        if ((*it >> 6) != version) {
+            throw std::runtime_error("Wire header: unsupported protocol version.");
+        }
+
+        const bool withMsgID = (*it & 0x20) != 0;
+        msgType = static_cast<MsgTypeType>(*it & 0x1f);
+        ++it;
+
+        msgID = 0;
+        if (withMsgID) {
+            it = decodeVarint(it, end, msgID);
+        }
+        it = decodeVarint(it, end, contextID);
+        it = decodeVarint(it, end, vAddr);
+        it = decodeVarint(it, end, tag);
+        return it - begin;
+    }
+
+  private:
+    static std::size_t varintSize(unsigned value)
+    {
+        std::size_t size = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            ++size;
+        }
+        return size;
+    }
+
+    static std::uint8_t* encodeVarint(unsigned value, std::uint8_t* out)
+    {
+        while (value >= 0x80) {
+            *out++ = static_cast<std::uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = static_cast<std::uint8_t>(value);
+        return out;
+    }
+
+    static std::uint8_t const*
+    decodeVarint(std::uint8_t const* it, std::uint8_t const* const end, unsigned& value)
+    {
+        value = 0;
+        for (unsigned shift = 0; shift < 35; shift += 7) {
+            if (it == end) {
+                throw std::runtime_error("Wire header: truncated message.");
+            }
+            value |= static_cast<unsigned>(*it & 0x7f) << shift;
+            if ((*it++ & 0x80) == 0) {
+                return it;
+            }
+        }
+        throw std::runtime_error("Wire header: varint too long.");
+    }
+};
+
+} // namespace socket
+
+} // namespace communicationPolicy
+
+} // namespace graybat
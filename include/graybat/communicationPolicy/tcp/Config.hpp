@@ -0,0 +1,72 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Stl
+#include <cstddef>
+#include <string>
+
+namespace graybat {
+
+namespace communicationPolicy {
+
+namespace tcp {
+
+/**
+ * @brief Configuration of the TCP policy, the options shared with
+ *        the ZMQ policy mean the same, see zmq::Config.
+ */
+struct Config {
+
+    std::string masterUri;
+    std::string peerUri;
+    size_t contextSize;
+    std::string contextName = "context";
+    size_t maxBufferSize = 100 * 1000 * 1000;
+    size_t maxSendSockets = 0;
+
+    // Connecting to a peer is retried until it listens or
+    // connectTimeoutMs milliseconds passed
+    size_t connectTimeoutMs = 60 * 1000;
+
+    // Wait for incoming streams in an io_uring instead of epoll and
+    // submit the batches to all peers, of a flush or expired at
+    // once, by a single io_uring submission. Only batches are sent
+    // by the ring, thus sends need batchSize > 0 to use it.
+    bool ioUring = false;
+
+    size_t nRecvWorkers = 0;
+    size_t batchSize = 0;
+    size_t batchTimeoutUs = 100;
+    size_t rendezvousThreshold = 0;
+    size_t chunkSize = 0;
+    size_t nRails = 1;
+
+    size_t bootstrapGroupSize = 0;
+    size_t bootstrapRank = 0;
+    std::string bootstrapDir = "/tmp";
+};
+
+} // namespace tcp
+
+} // namespace communicationPolicy
+
+} // namespace graybat
@@ -0,0 +1,124 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Stl
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+// Graybat
+#include <graybat/utils/BufferPool.hpp>
+
+namespace graybat {
+
+namespace communicationPolicy {
+
+namespace tcp {
+
+/**
+ * @brief Bytes of a message on the wire, header included. The
+ *        buffer comes from the BufferPool and is released when the
+ *        frame is destroyed. Frames can be moved but not copied.
+ */
+class Frame {
+  public:
+    // Frames are sent with a 32 bit size in front
+    static constexpr std::size_t maxSize = std::numeric_limits<std::uint32_t>::max();
+
+    Frame()
+        : data_(nullptr)
+        , size_(0)
+    {
+    }
+
+    explicit Frame(std::size_t const size)
+        : data_(size > 0 ? utils::BufferPool::instance().allocate(checked(size)) : nullptr)
+        , size_(size)
+    {
+    }
+
+    Frame(Frame&& other)
+        : data_(other.data_)
+        , size_(other.size_)
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    Frame& operator=(Frame&& other)
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    Frame(const Frame&) = delete;
+    Frame& operator=(const Frame&) = delete;
+
+    ~Frame()
+    {
+        if (data_ != nullptr) {
+            utils::BufferPool::instance().deallocate(data_);
+        }
+    }
+
+    void* data()
+    {
+        return data_;
+    }
+
+    const void* data() const
+    {
+        return data_;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Returns *size*, throws if a frame of that size can not
+     *        be sent.
+     */
+    static std::size_t checked(std::size_t const size)
+    {
+        if (size > maxSize) {
+            throw std::length_error(
+                "Frame of " + std::to_string(size) + " bytes exceeds the 4 GiB frame size limit.");
+        }
+        return size;
+    }
+
+  private:
+    void* data_;
+    std::size_t size_;
+};
+
+} // namespace tcp
+
+} // namespace communicationPolicy
+
+} // namespace graybat
@@ -0,0 +1,215 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Stl
+#include <cstdint>
+#include <cstring>
+
+// Graybat
+#include <graybat/communicationPolicy/Traits.hpp>
+#include <graybat/communicationPolicy/socket/WireHeader.hpp>
+#include <graybat/communicationPolicy/tcp/Frame.hpp>
+
+namespace graybat {
+
+namespace communicationPolicy {
+
+namespace tcp {
+
+/**
+ * @brief Message of the TCP policy, a wire header followed by the
+ *        payload in a single frame. Same interface as the message
+ *        of the ZMQ policy, thus socket::Base handles both.
+ *
+ * A message created from user data only encodes the header into its
+ * frame and borrows the payload, the socket gathers both when the
+ * message is sent.
+ */
+template <typename T_CommunicationPolicy> struct Message {
+
+    // Types
+    using CommunicationPolicy = T_CommunicationPolicy;
+    using ContextID = typename graybat::communicationPolicy::ContextID<CommunicationPolicy>;
+    using VAddr = typename graybat::communicationPolicy::VAddr<CommunicationPolicy>;
+    using Tag = typename graybat::communicationPolicy::Tag<CommunicationPolicy>;
+    using MsgType = typename graybat::communicationPolicy::MsgType<CommunicationPolicy>;
+    using MsgID = typename graybat::communicationPolicy::MsgID<CommunicationPolicy>;
+
+    // Members
+    socket::WireHeader header;
+    std::size_t headerSize;
+    Frame frame;
+    const std::int8_t* payload;
+    std::size_t payloadSize;
+
+    Message()
+        : header()
+        , headerSize(0)
+        , payload(nullptr)
+        , payloadSize(0)
+    {
+    }
+
+    /**
+     * @brief Copies a complete message, header included, from *bytes*.
+     */
+    Message(const void* bytes, std::size_t const size)
+        : frame(size)
+        , payload(nullptr)
+        , payloadSize(0)
+    {
+        std::memcpy(frame.data(), bytes, size);
+        decodeHeader();
+    }
+
+    /**
+     * @brief Borrows *data* as payload, which thus needs to outlive
+     *        the send of the message.
+     */
+    template <typename T_Data>
+    Message(
+        MsgType const msgType,
+        MsgID const msgID,
+        ContextID const contextID,
+        VAddr const srcVAddr,
+        Tag const tag,
+        T_Data& data)
+        : Message(msgType, msgID, contextID, srcVAddr, tag, 0)
+    {
+        // Empty containers may hand out a nullptr
+        payloadSize = data.size() * sizeof(typename T_Data::value_type);
+        payload = payloadSize > 0 ? reinterpret_cast<const std::int8_t*>(data.data()) : nullptr;
+        Frame::checked(frame.size() + payloadSize);
+    }
+
+    /**
+     * @brief Creates a message with room for *dataSize* bytes of
+     *        payload, to be filled via getData().
+     */
+    Message(
+        MsgType const msgType,
+        MsgID const msgID,
+        ContextID const contextID,
+        VAddr const srcVAddr,
+        Tag const tag,
+        std::size_t const dataSize)
+        : header{ msgType, msgID, contextID, srcVAddr, tag }
+        , headerSize(header.encodedSize())
+        , frame(headerSize + dataSize)
+        , payload(nullptr)
+        , payloadSize(0)
+    {
+        header.encode(getFrame());
+    }
+
+    /**
+     * @brief Decodes the header of a received message, needs to be
+     *        called once after the frame was filled by a socket.
+     */
+    void decodeHeader()
+    {
+        headerSize = header.decode(getFrame(), frame.size());
+    }
+
+    MsgType getMsgType()
+    {
+        return header.msgType;
+    }
+
+    MsgID getMsgID()
+    {
+        return header.msgID;
+    }
+
+    ContextID getContextID()
+    {
+        return header.contextID;
+    }
+
+    VAddr getVAddr()
+    {
+        return header.vAddr;
+    }
+
+    Tag getTag()
+    {
+        return header.tag;
+    }
+
+    /**
+     * @brief Size of the payload in bytes.
+     */
+    std::size_t size()
+    {
+        return frame.size() - headerSize + payloadSize;
+    }
+
+    /**
+     * @brief Size of the data the message delivers, for a request to
+     *        send the size it announces.
+     */
+    std::size_t getDataSize()
+    {
+        if (header.msgType == MsgType::REQUEST_TO_SEND) {
+            std::uint64_t dataSize = 0;
+            std::memcpy(&dataSize, getData(), sizeof(dataSize));
+            return dataSize;
+        }
+        return size();
+    }
+
+    /**
+     * @brief Payload of the message, a borrowed one is only read.
+     */
+    std::int8_t* getData()
+    {
+        return payload ? const_cast<std::int8_t*>(payload) : getFrame() + headerSize;
+    }
+
+    Frame& getMessage()
+    {
+        return frame;
+    }
+
+    /**
+     * @brief Start of the frame, which is followed by the payload
+     *        when that is borrowed.
+     */
+    std::int8_t* getFrame()
+    {
+        return static_cast<std::int8_t*>(frame.data());
+    }
+
+    /**
+     * @brief Size of the complete message, header included.
+     */
+    std::size_t getFrameSize()
+    {
+        return frame.size() + payloadSize;
+    }
+};
+
+} // namespace tcp
+
+} // namespace communicationPolicy
+
+} // namespace graybat
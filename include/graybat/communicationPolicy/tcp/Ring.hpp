@@ -0,0 +1,311 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Clib
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Stl
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+namespace graybat {
+
+namespace communicationPolicy {
+
+namespace tcp {
+
+/**
+ * @brief Minimal io_uring instance, talks to the kernel by the raw
+ *        system calls, thus no liburing is needed.
+ *
+ * Sqes are queued by getSqe() and submitted together by a single
+ * submit(), which can wait for completions as well. A ring can own
+ * a provided buffer ring, from which multishot receives pick the
+ * buffers they fill. Rings are not thread safe.
+ */
+class Ring {
+  public:
+    explicit Ring(unsigned const entries)
+        : ringFd(-1)
+        , ringMem(MAP_FAILED)
+        , ringSize(0)
+        , sqeMem(MAP_FAILED)
+        , sqeSize(0)
+        , sqeTail(0)
+        , nUnsubmitted(0)
+        , bufferRing(MAP_FAILED)
+        , bufferRingSize(0)
+        , nBuffers(0)
+        , bufferSize(0)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ringFd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (ringFd < 0) {
+            throw std::system_error(errno, std::system_category(), "io_uring_setup");
+        }
+        if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+            ::close(ringFd);
+            throw std::system_error(ENOSYS, std::system_category(), "io_uring single mmap");
+        }
+
+        // Submission and completion queue share one mapping
+        ringSize = std::max<std::size_t>(
+            params.sq_off.array + params.sq_entries * sizeof(unsigned),
+            params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+        ringMem = ::mmap(
+            nullptr,
+            ringSize,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            ringFd,
+            IORING_OFF_SQ_RING);
+        sqeSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqeMem = ::mmap(
+            nullptr,
+            sqeSize,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            ringFd,
+            IORING_OFF_SQES);
+        if (ringMem == MAP_FAILED || sqeMem == MAP_FAILED) {
+            const int error = errno;
+            close();
+            throw std::system_error(error, std::system_category(), "io_uring mmap");
+        }
+
+        std::int8_t* ring = static_cast<std::int8_t*>(ringMem);
+        sqHead = reinterpret_cast<unsigned*>(ring + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(ring + params.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned*>(ring + params.sq_off.ring_mask);
+        sqEntries = params.sq_entries;
+        sqArray = reinterpret_cast<unsigned*>(ring + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(ring + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(ring + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(ring + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(ring + params.cq_off.cqes);
+        sqes = static_cast<io_uring_sqe*>(sqeMem);
+        sqeTail = *sqTail;
+    }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    ~Ring()
+    {
+        close();
+    }
+
+    /**
+     * @brief Returns a cleared sqe to be filled by the caller, or a
+     *        nullptr when the submission queue is full.
+     */
+    io_uring_sqe* getSqe()
+    {
+        const unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (sqeTail - head >= sqEntries) {
+            return nullptr;
+        }
+
+        const unsigned index = sqeTail & sqMask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqArray[index] = index;
+        sqeTail++;
+        nUnsubmitted++;
+        return sqe;
+    }
+
+    /**
+     * @brief Submits all queued sqes and waits until at least
+     *        *nCompletions* completions are available, in a single
+     *        system call.
+     */
+    void submit(unsigned const nCompletions = 0)
+    {
+        __atomic_store_n(sqTail, sqeTail, __ATOMIC_RELEASE);
+
+        while (true) {
+            const unsigned flags = nCompletions > 0 ? IORING_ENTER_GETEVENTS : 0;
+            const long submitted = ::syscall(
+                __NR_io_uring_enter, ringFd, nUnsubmitted, nCompletions, flags, nullptr, 0);
+            if (submitted < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::system_category(), "io_uring_enter");
+            }
+            nUnsubmitted -= std::min<unsigned>(submitted, nUnsubmitted);
+            return;
+        }
+    }
+
+    /**
+     * @brief Calls *f* for each available completion, returns the
+     *        number of completions.
+     */
+    template <typename T_Functor> unsigned forEachCompletion(T_Functor&& f)
+    {
+        unsigned head = *cqHead;
+        const unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        const unsigned nCompletions = tail - head;
+
+        for (; head != tail; ++head) {
+            f(cqes[head & cqMask]);
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        return nCompletions;
+    }
+
+    /**
+     * @brief Returns whether the kernel supports *opcode*, kernels
+     *        which cannot be probed support none.
+     */
+    bool supports(std::uint8_t const opcode) const
+    {
+        const std::size_t nOps = 256;
+        std::vector<std::int8_t> probeMem(
+            sizeof(io_uring_probe) + nOps * sizeof(io_uring_probe_op), 0);
+        io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(probeMem.data());
+        if (::syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, probe, nOps) != 0) {
+            return false;
+        }
+        return opcode <= probe->last_op && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED);
+    }
+
+    /**
+     * @brief Registers *nProvided* buffers of *providedSize* bytes
+     *        as buffer group *groupID*. *nProvided* must be a power
+     *        of two.
+     */
+    void provideBuffers(
+        std::uint16_t const groupID, unsigned const nProvided, std::size_t const providedSize)
+    {
+        nBuffers = nProvided;
+        bufferSize = providedSize;
+        buffers.resize(nBuffers * bufferSize);
+
+        // The kernel reads the buffer ring, thus it needs page alignment
+        bufferRingSize = nBuffers * sizeof(io_uring_buf);
+        bufferRing = ::mmap(
+            nullptr, bufferRingSize, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+        if (bufferRing == MAP_FAILED) {
+            throw std::system_error(errno, std::system_category(), "io_uring buffer ring mmap");
+        }
+
+        io_uring_buf_reg reg;
+        std::memset(&reg, 0, sizeof(reg));
+        reg.ring_addr = reinterpret_cast<std::uint64_t>(bufferRing);
+        reg.ring_entries = nBuffers;
+        reg.bgid = groupID;
+        if (::syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+            throw std::system_error(errno, std::system_category(), "io_uring register buffers");
+        }
+
+        bufferTail = 0;
+        for (unsigned buffer_i = 0; buffer_i < nBuffers; ++buffer_i) {
+            recycle(buffer_i);
+        }
+    }
+
+    std::int8_t* getBuffer(std::uint16_t const bufferID)
+    {
+        return buffers.data() + bufferID * bufferSize;
+    }
+
+    /**
+     * @brief Hands a consumed buffer back to the kernel.
+     */
+    void recycle(std::uint16_t const bufferID)
+    {
+        io_uring_buf* bufs = static_cast<io_uring_buf*>(bufferRing);
+        io_uring_buf& buf = bufs[bufferTail & (nBuffers - 1)];
+        buf.addr = reinterpret_cast<std::uint64_t>(getBuffer(bufferID));
+        buf.len = bufferSize;
+        buf.bid = bufferID;
+        bufferTail++;
+        __atomic_store_n(
+            &static_cast<io_uring_buf_ring*>(bufferRing)->tail, bufferTail, __ATOMIC_RELEASE);
+    }
+
+  private:
+    int ringFd;
+    void* ringMem;
+    std::size_t ringSize;
+    void* sqeMem;
+    std::size_t sqeSize;
+
+    unsigned* sqHead;
+    unsigned* sqTail;
+    unsigned sqMask;
+    unsigned sqEntries;
+    unsigned* sqArray;
+    io_uring_sqe* sqes;
+    unsigned sqeTail;
+    unsigned nUnsubmitted;
+
+    unsigned* cqHead;
+    unsigned* cqTail;
+    unsigned cqMask;
+    io_uring_cqe* cqes;
+
+    void* bufferRing;
+    std::size_t bufferRingSize;
+    unsigned nBuffers;
+    std::size_t bufferSize;
+    std::uint16_t bufferTail;
+    std::vector<std::int8_t> buffers;
+
+    void close()
+    {
+        if (ringMem != MAP_FAILED) {
+            ::munmap(ringMem, ringSize);
+            ringMem = MAP_FAILED;
+        }
+        if (sqeMem != MAP_FAILED) {
+            ::munmap(sqeMem, sqeSize);
+            sqeMem = MAP_FAILED;
+        }
+        if (ringFd >= 0) {
+            ::close(ringFd);
+            ringFd = -1;
+        }
+        // Unmapped after the ring is gone, which unregisters it
+        if (bufferRing != MAP_FAILED) {
+            ::munmap(bufferRing, bufferRingSize);
+            bufferRing = MAP_FAILED;
+        }
+    }
+};
+
+} // namespace tcp
+
+} // namespace communicationPolicy
+
+} // namespace graybat
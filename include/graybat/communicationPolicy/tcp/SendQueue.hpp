@@ -0,0 +1,199 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Clib
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+// Stl
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// Graybat
+#include <graybat/communicationPolicy/tcp/Frame.hpp>
+#include <graybat/communicationPolicy/tcp/Ring.hpp>
+#include <graybat/communicationPolicy/tcp/Socket.hpp>
+
+namespace graybat {
+
+namespace communicationPolicy {
+
+namespace tcp {
+
+/**
+ * @brief Collects frames for connected sockets and sends them all
+ *        by a single io_uring submission.
+ *
+ * Frames to different sockets are sent concurrently, frames to the
+ * same socket are linked and thus keep their order. submit() returns
+ * when all frames are sent, what the kernel did not send completely
+ * is sent by the socket itself. Not thread safe.
+ */
+class SendQueue {
+  public:
+    explicit SendQueue(unsigned const capacity)
+        : ring(capacity)
+        , capacity(capacity)
+    {
+        sends.reserve(capacity);
+        order.reserve(capacity);
+        spareBuffers.reserve(capacity);
+    }
+
+    /**
+     * @brief Takes *frame* to be sent on *socket* by the next submit.
+     */
+    void push(Socket& socket, Frame& frame)
+    {
+        std::vector<std::int8_t> noPayload;
+        push(socket, frame, noPayload);
+    }
+
+    /**
+     * @brief Takes *frame* followed by the bytes of *payload* as a
+     *        single frame. *payload* is swapped with an empty buffer
+     *        of an earlier send, thus its bytes are not copied.
+     */
+    void push(Socket& socket, Frame& frame, std::vector<std::int8_t>& payload)
+    {
+        if (sends.size() == capacity) {
+            submit();
+        }
+
+        std::vector<std::int8_t> buffer;
+        if (!spareBuffers.empty()) {
+            buffer.swap(spareBuffers.back());
+            spareBuffers.pop_back();
+        }
+        buffer.swap(payload);
+        sends.emplace_back(socket, std::move(frame), std::move(buffer));
+    }
+
+    void submit()
+    {
+        if (sends.empty()) {
+            return;
+        }
+
+        // Chains of sends to the same socket, in the order pushed
+        order.clear();
+        for (std::size_t send_i = 0; send_i < sends.size(); ++send_i) {
+            order.push_back(send_i);
+        }
+        std::stable_sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+            return sends[a].socket->handle() < sends[b].socket->handle();
+        });
+
+        for (std::size_t order_i = 0; order_i < order.size(); ++order_i) {
+            Send& send = sends[order[order_i]];
+            send.prepare();
+
+            io_uring_sqe* sqe = ring.getSqe();
+            sqe->opcode = IORING_OP_SENDMSG;
+            sqe->fd = send.socket->handle();
+            sqe->addr = reinterpret_cast<std::uint64_t>(&send.msg);
+            sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+            sqe->user_data = order[order_i];
+            if (order_i + 1 < order.size()
+                && sends[order[order_i + 1]].socket->handle() == send.socket->handle()) {
+                sqe->flags = IOSQE_IO_LINK;
+            }
+        }
+
+        // Sends broken off, partially or by a short send before
+        // them in the same chain, are finished below
+        unsigned nCompleted = 0;
+        ring.submit(sends.size());
+        while (true) {
+            nCompleted += ring.forEachCompletion([this](io_uring_cqe const& cqe) {
+                sends[cqe.user_data].sent = cqe.res > 0 ? cqe.res : 0;
+            });
+            if (nCompleted == sends.size()) {
+                break;
+            }
+            ring.submit(sends.size() - nCompleted);
+        }
+
+        for (std::size_t const send_i : order) {
+            Send& send = sends[send_i];
+            if (send.sent < sizeof(send.frameSize) + send.frameSize) {
+                send.socket->send(send.frame, send.payload.data(), send.payload.size(), send.sent);
+            }
+            send.payload.clear();
+            spareBuffers.push_back(std::move(send.payload));
+        }
+        sends.clear();
+    }
+
+  private:
+    struct Send {
+        Send(Socket& socket, Frame&& frame, std::vector<std::int8_t>&& payload)
+            : socket(&socket)
+            , frame(std::move(frame))
+            , payload(std::move(payload))
+            , frameSize(0)
+            , sent(0)
+        {
+        }
+
+        // Points into the send, which does not move once prepared
+        void prepare()
+        {
+            frameSize = static_cast<std::uint32_t>(frame.size() + payload.size());
+            iov[0].iov_base = &frameSize;
+            iov[0].iov_len = sizeof(frameSize);
+            iov[1].iov_base = frame.data();
+            iov[1].iov_len = frame.size();
+            iov[2].iov_base = payload.data();
+            iov[2].iov_len = payload.size();
+            std::memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = iov;
+            msg.msg_iovlen = payload.empty() ? 2 : 3;
+        }
+
+        Socket* socket;
+        Frame frame;
+        std::vector<std::int8_t> payload;
+        std::uint32_t frameSize;
+        iovec iov[3];
+        msghdr msg;
+        std::size_t sent;
+    };
+
+    Ring ring;
+    const std::size_t capacity;
+    std::vector<Send> sends;
+    std::vector<std::size_t> order;
+
+    // Payloads of sent frames, handed back to the callers by push
+    std::vector<std::vector<std::int8_t>> spareBuffers;
+};
+
+} // namespace tcp
+
+} // namespace communicationPolicy
+
+} // namespace graybat
@@ -0,0 +1,718 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Clib
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Stl
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Graybat
+#include <graybat/communicationPolicy/tcp/Frame.hpp>
+#include <graybat/communicationPolicy/tcp/Ring.hpp>
+
+namespace graybat {
+
+namespace communicationPolicy {
+
+namespace tcp {
+
+/**
+ * @brief Socket of the TCP policy.
+ *
+ * A connected socket is a single stream to a peer, frames are sent
+ * with their size in front. A bound socket accepts the streams of
+ * all peers and waits for them in an epoll event loop, run by the
+ * thread which receives. Uris are tcp://host:port or ipc://path,
+ * the latter a unix domain socket. Sockets are not thread safe.
+ *
+ * A bound socket created with ioUring waits in an io_uring instead:
+ * listeners and streams are served by multishot accepts and
+ * multishot receives, which fill buffers provided to the ring, thus
+ * waiting and receiving take a single system call. On kernels
+ * without multishot receives, before Linux 6.0, it waits in epoll.
+ */
+class Socket {
+  public:
+    // Frames up to this size are read in bulk and copied out,
+    // larger frames are read right into their buffer
+    static constexpr std::size_t stagingSize = 64 * 1024;
+
+    // Ring of an io_uring socket and the buffers it provides to
+    // multishot receives, the number of buffers is a power of two
+    static constexpr unsigned ringEntries = 256;
+    static constexpr unsigned nProvidedBuffers = 128;
+    static constexpr std::size_t providedBufferSize = 32 * 1024;
+
+    Socket()
+        : fd(-1)
+        , epollFd(-1)
+    {
+    }
+
+    explicit Socket(bool const ioUring)
+        : Socket()
+    {
+        if (ioUring) {
+            ring.reset(new Ring(ringEntries));
+            if (!supportsMultishot(*ring)) {
+                ring.reset();
+                return;
+            }
+            ring->provideBuffers(bufferGroup, nProvidedBuffers, providedBufferSize);
+        }
+    }
+
+    Socket(Socket&& other)
+        : Socket()
+    {
+        *this = std::move(other);
+    }
+
+    Socket& operator=(Socket&& other)
+    {
+        std::swap(fd, other.fd);
+        std::swap(epollFd, other.epollFd);
+        std::swap(listeners, other.listeners);
+        std::swap(connections, other.connections);
+        std::swap(frames, other.frames);
+        std::swap(ring, other.ring);
+        return *this;
+    }
+
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+
+    ~Socket()
+    {
+        close();
+    }
+
+    /**
+     * @brief Connects to a bound socket at *uri*, retries until the
+     *        socket is bound or *timeout* passed.
+     */
+    void connect(std::string const& uri, std::chrono::milliseconds const timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        while (true) {
+            Address address = resolve(uri);
+            fd = ::socket(address.family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd < 0) {
+                throw std::system_error(errno, std::system_category(), "socket " + uri);
+            }
+
+            if (::connect(fd, address.get(), address.size) == 0) {
+                break;
+            }
+
+            const int error = errno;
+            ::close(fd);
+            fd = -1;
+            if ((error != ECONNREFUSED && error != ENOENT)
+                || std::chrono::steady_clock::now() >= deadline) {
+                throw std::system_error(error, std::system_category(), "connect " + uri);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        setNoDelay(fd);
+    }
+
+    int handle() const
+    {
+        return fd;
+    }
+
+    /**
+     * @brief Sends *frame* in a single sendmsg, the size in front is
+     *        gathered from a separate buffer. The first *sent* bytes
+     *        of size and frame are skipped, they were sent before.
+     */
+    void send(Frame const& frame, std::size_t const sent = 0)
+    {
+        send(frame, nullptr, 0, sent);
+    }
+
+    /**
+     * @brief Sends *frame* followed by *payloadSize* bytes of
+     *        *payload* as a single frame, gathered by the same
+     *        sendmsg, thus the payload is not copied.
+     */
+    void send(
+        Frame const& frame,
+        const void* const payload,
+        std::size_t const payloadSize,
+        std::size_t const sent = 0)
+    {
+        // Frames are never larger than Frame::maxSize
+        const std::uint32_t frameSize = static_cast<std::uint32_t>(frame.size() + payloadSize);
+        iovec iov[3];
+        iov[0].iov_base = const_cast<std::uint32_t*>(&frameSize);
+        iov[0].iov_len = sizeof(frameSize);
+        iov[1].iov_base = const_cast<void*>(frame.data());
+        iov[1].iov_len = frame.size();
+        iov[2].iov_base = const_cast<void*>(payload);
+        iov[2].iov_len = payloadSize;
+
+        msghdr msg = {};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = payloadSize > 0 ? 3 : 2;
+
+        std::size_t skip = sent;
+        while (true) {
+            // Skip what was sent before or on a partial send
+            while (msg.msg_iovlen > 0 && skip >= msg.msg_iov->iov_len) {
+                skip -= msg.msg_iov->iov_len;
+                msg.msg_iov++;
+                msg.msg_iovlen--;
+            }
+            if (msg.msg_iovlen == 0) {
+                return;
+            }
+            msg.msg_iov->iov_base = static_cast<char*>(msg.msg_iov->iov_base) + skip;
+            msg.msg_iov->iov_len -= skip;
+
+            const ssize_t nBytes = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+            if (nBytes < 0) {
+                if (errno == EINTR) {
+                    skip = 0;
+                    continue;
+                }
+                throw std::system_error(errno, std::system_category(), "sendmsg");
+            }
+            skip = nBytes;
+        }
+    }
+
+    /**
+     * @brief Listens on *uri*, a socket may listen on several uris.
+     */
+    void bind(std::string const& uri)
+    {
+        if (epollFd < 0 && !ring) {
+            epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+            if (epollFd < 0) {
+                throw std::system_error(errno, std::system_category(), "epoll_create1");
+            }
+        }
+
+        Address address = resolve(uri);
+        const int listener = ::socket(address.family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listener < 0) {
+            throw std::system_error(errno, std::system_category(), "socket " + uri);
+        }
+
+        if (address.family == AF_UNIX) {
+            ::unlink(address.un.sun_path);
+        } else {
+            const int reuse = 1;
+            ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        }
+
+        if (::bind(listener, address.get(), address.size) != 0
+            || ::listen(listener, SOMAXCONN) != 0) {
+            const int error = errno;
+            ::close(listener);
+            throw std::system_error(error, std::system_category(), "bind " + uri);
+        }
+
+        if (ring) {
+            accept(listener);
+        } else {
+            watch(listener);
+        }
+        listeners[listener] = uri;
+    }
+
+    void unbind(std::string const& uri)
+    {
+        for (auto it = listeners.begin(); it != listeners.end(); ++it) {
+            if (it->second == uri) {
+                // The pending accept keeps the listener open otherwise
+                if (ring) {
+                    io_uring_sqe* sqe = getSqe();
+                    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+                    sqe->addr = userData(Operation::Accept, it->first);
+                    sqe->user_data = userData(Operation::Cancel, it->first);
+                    ring->submit();
+                }
+                closeListener(*it);
+                listeners.erase(it);
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Blocks until a frame arrived on any stream accepted by
+     *        this socket. Closed streams are dropped silently.
+     */
+    void recv(Frame& frame)
+    {
+        while (frames.empty()) {
+            if (ring) {
+                waitRing();
+            } else {
+                waitEpoll();
+            }
+        }
+
+        frame = std::move(frames.front());
+        frames.pop_front();
+    }
+
+  private:
+    struct Address {
+        int family;
+        socklen_t size;
+        union {
+            sockaddr_storage storage;
+            sockaddr_un un;
+        };
+
+        const sockaddr* get() const
+        {
+            return reinterpret_cast<const sockaddr*>(&storage);
+        }
+    };
+
+    /**
+     * @brief Read state of an accepted stream.
+     */
+    struct Connection {
+        Connection()
+            : staging(stagingSize)
+            , staged(0)
+            , received(0)
+        {
+        }
+
+        std::vector<std::int8_t> staging;
+        std::size_t staged;
+
+        // Large frame which is read right into its buffer
+        Frame frame;
+        std::size_t received;
+    };
+
+    // Operations in flight on the ring, user data of their sqes is
+    // the operation in the upper and the fd in the lower half
+    enum class Operation : std::uint32_t { Accept = 1, Recv = 2, Cancel = 3 };
+    static constexpr std::uint16_t bufferGroup = 0;
+
+    int fd;
+    int epollFd;
+    std::map<int, std::string> listeners;
+    std::unordered_map<int, Connection> connections;
+    std::deque<Frame> frames;
+    std::unique_ptr<Ring> ring;
+
+    static Address resolve(std::string const& uri)
+    {
+        const std::string ipcScheme = "ipc://";
+        const std::string tcpScheme = "tcp://";
+
+        Address address;
+        std::memset(&address.storage, 0, sizeof(address.storage));
+
+        if (uri.compare(0, ipcScheme.size(), ipcScheme) == 0) {
+            const std::string path = uri.substr(ipcScheme.size());
+            if (path.size() >= sizeof(address.un.sun_path)) {
+                throw std::runtime_error("Ipc path too long: " + uri);
+            }
+            address.family = AF_UNIX;
+            address.un.sun_family = AF_UNIX;
+            std::strncpy(address.un.sun_path, path.c_str(), sizeof(address.un.sun_path) - 1);
+            address.size = sizeof(address.un);
+            return address;
+        }
+
+        if (uri.compare(0, tcpScheme.size(), tcpScheme) != 0 || uri.rfind(':') < tcpScheme.size()) {
+            throw std::runtime_error("Unsupported uri: " + uri);
+        }
+
+        const std::string host = uri.substr(tcpScheme.size(), uri.rfind(':') - tcpScheme.size());
+        const std::string port = uri.substr(uri.rfind(':') + 1);
+
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* result = nullptr;
+        const int error = ::getaddrinfo(host == "*" ? nullptr : host.c_str(), port.c_str(), &hints, &result);
+        if (error != 0) {
+            throw std::runtime_error("Can not resolve " + uri + ": " + ::gai_strerror(error));
+        }
+
+        address.family = result->ai_family;
+        address.size = result->ai_addrlen;
+        std::memcpy(&address.storage, result->ai_addr, result->ai_addrlen);
+        ::freeaddrinfo(result);
+        return address;
+    }
+
+    static void setNoDelay(int const socketFd)
+    {
+        sockaddr_storage address;
+        socklen_t size = sizeof(address);
+        if (::getsockname(socketFd, reinterpret_cast<sockaddr*>(&address), &size) == 0
+            && address.ss_family != AF_UNIX) {
+            const int noDelay = 1;
+            ::setsockopt(socketFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+    }
+
+    void watch(int const watchedFd)
+    {
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = watchedFd;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, watchedFd, &event) != 0) {
+            throw std::system_error(errno, std::system_category(), "epoll_ctl");
+        }
+    }
+
+    void waitEpoll()
+    {
+        epoll_event events[64];
+        const int nEvents = ::epoll_wait(epollFd, events, 64, -1);
+        if (nEvents < 0) {
+            if (errno == EINTR) {
+                return;
+            }
+            throw std::system_error(errno, std::system_category(), "epoll_wait");
+        }
+
+        for (int event_i = 0; event_i < nEvents; ++event_i) {
+            const int eventFd = events[event_i].data.fd;
+            if (listeners.count(eventFd)) {
+                acceptAll(eventFd);
+            } else {
+                read(eventFd);
+            }
+        }
+    }
+
+    void acceptAll(int const listener)
+    {
+        while (true) {
+            const int stream = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (stream < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) {
+                    continue;
+                }
+                return;
+            }
+            setNoDelay(stream);
+            watch(stream);
+            connections[stream];
+        }
+    }
+
+    static void closeListener(std::pair<const int, std::string> const& listener)
+    {
+        const std::string ipcScheme = "ipc://";
+        if (listener.second.compare(0, ipcScheme.size(), ipcScheme) == 0) {
+            ::unlink(listener.second.substr(ipcScheme.size()).c_str());
+        }
+        ::close(listener.first);
+    }
+
+    void drop(int const stream)
+    {
+        if (epollFd >= 0) {
+            ::epoll_ctl(epollFd, EPOLL_CTL_DEL, stream, nullptr);
+        }
+        ::close(stream);
+        connections.erase(stream);
+    }
+
+    static std::uint64_t userData(Operation const operation, int const operationFd)
+    {
+        return (static_cast<std::uint64_t>(operation) << 32)
+            | static_cast<std::uint32_t>(operationFd);
+    }
+
+    io_uring_sqe* getSqe()
+    {
+        io_uring_sqe* sqe = ring->getSqe();
+        if (sqe == nullptr) {
+            ring->submit();
+            sqe = ring->getSqe();
+        }
+        return sqe;
+    }
+
+    /**
+     * @brief Returns whether *ring* serves multishot accepts and
+     *        receives. Probes see opcodes but no flags, thus
+     *        IORING_RECV_MULTISHOT is detected by IORING_OP_SEND_ZC,
+     *        which came with it in Linux 6.0.
+     */
+    static bool supportsMultishot(Ring const& ring)
+    {
+        return ring.supports(IORING_OP_ACCEPT) && ring.supports(IORING_OP_RECV)
+            && ring.supports(IORING_OP_SEND_ZC);
+    }
+
+    /**
+     * @brief Accepts all streams of *listener* until it is unbound.
+     */
+    void accept(int const listener)
+    {
+        io_uring_sqe* sqe = getSqe();
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->fd = listener;
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe->accept_flags = SOCK_CLOEXEC;
+        sqe->user_data = userData(Operation::Accept, listener);
+    }
+
+    /**
+     * @brief Receives from *stream* into provided buffers until the
+     *        stream is closed.
+     */
+    void receive(int const stream)
+    {
+        io_uring_sqe* sqe = getSqe();
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = stream;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = bufferGroup;
+        sqe->user_data = userData(Operation::Recv, stream);
+    }
+
+    /**
+     * @brief Submits the queued sqes, waits for at least one
+     *        completion and handles all completions.
+     */
+    void waitRing()
+    {
+        ring->submit(1);
+        ring->forEachCompletion([this](io_uring_cqe const& cqe) {
+            const Operation operation = static_cast<Operation>(cqe.user_data >> 32);
+            const int operationFd = static_cast<int>(cqe.user_data & 0xffffffff);
+            const bool more = cqe.flags & IORING_CQE_F_MORE;
+
+            if (operation == Operation::Accept) {
+                if (cqe.res >= 0) {
+                    setNoDelay(cqe.res);
+                    connections[cqe.res];
+                    receive(cqe.res);
+                }
+                if (!more && cqe.res != -ECANCELED && listeners.count(operationFd)) {
+                    accept(operationFd);
+                }
+
+            } else if (operation == Operation::Recv) {
+                if (cqe.flags & IORING_CQE_F_BUFFER) {
+                    const std::uint16_t bufferID = cqe.flags >> IORING_CQE_BUFFER_SHIFT;
+                    if (cqe.res > 0) {
+                        consume(connections.at(operationFd), ring->getBuffer(bufferID), cqe.res);
+                    }
+                    ring->recycle(bufferID);
+                }
+                if (!more) {
+                    // Out of buffers the stream is still open
+                    if (cqe.res > 0 || cqe.res == -ENOBUFS) {
+                        receive(operationFd);
+                    } else if (
+                        cqe.res == 0 || cqe.res == -ECONNRESET || cqe.res == -ECANCELED) {
+                        drop(operationFd);
+                    } else {
+                        throw std::system_error(
+                            -cqe.res, std::system_category(), "io_uring multishot recv");
+                    }
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Queues the frames completed by *size* received bytes.
+     */
+    void consume(Connection& connection, const std::int8_t* bytes, std::size_t size)
+    {
+        while (size > 0) {
+            if (connection.received < connection.frame.size()) {
+                const std::size_t n
+                    = std::min(size, connection.frame.size() - connection.received);
+                std::memcpy(
+                    static_cast<std::int8_t*>(connection.frame.data()) + connection.received,
+                    bytes,
+                    n);
+                connection.received += n;
+                bytes += n;
+                size -= n;
+                if (connection.received == connection.frame.size()) {
+                    frames.push_back(std::move(connection.frame));
+                    connection.frame = Frame();
+                    connection.received = 0;
+                }
+                continue;
+            }
+
+            const std::size_t n = std::min(size, connection.staging.size() - connection.staged);
+            std::memcpy(connection.staging.data() + connection.staged, bytes, n);
+            connection.staged += n;
+            bytes += n;
+            size -= n;
+            unstage(connection);
+        }
+    }
+
+    /**
+     * @brief Reads all data available on *stream* and queues the
+     *        completed frames.
+     */
+    void read(int const stream)
+    {
+        Connection& connection = connections.at(stream);
+
+        while (true) {
+            const bool direct = connection.received < connection.frame.size();
+            ssize_t nBytes = direct
+                ? ::read(
+                      stream,
+                      static_cast<std::int8_t*>(connection.frame.data()) + connection.received,
+                      connection.frame.size() - connection.received)
+                : ::read(
+                      stream,
+                      connection.staging.data() + connection.staged,
+                      connection.staging.size() - connection.staged);
+
+            if (nBytes < 0 && errno == EINTR) {
+                continue;
+            }
+            if (nBytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return;
+            }
+            if (nBytes <= 0) {
+                drop(stream);
+                return;
+            }
+
+            if (direct) {
+                connection.received += nBytes;
+                if (connection.received == connection.frame.size()) {
+                    frames.push_back(std::move(connection.frame));
+                    connection.frame = Frame();
+                    connection.received = 0;
+                }
+                continue;
+            }
+
+            connection.staged += nBytes;
+            unstage(connection);
+        }
+    }
+
+    /**
+     * @brief Copies the complete frames out of the staging buffer, a
+     *        frame too large for it continues to be read directly.
+     */
+    void unstage(Connection& connection)
+    {
+        std::size_t offset = 0;
+        std::uint32_t frameSize = 0;
+
+        while (connection.staged - offset >= sizeof(frameSize)) {
+            std::memcpy(&frameSize, connection.staging.data() + offset, sizeof(frameSize));
+            const std::int8_t* begin = connection.staging.data() + offset + sizeof(frameSize);
+            const std::size_t available = connection.staged - offset - sizeof(frameSize);
+
+            if (available >= frameSize) {
+                Frame frame(frameSize);
+                std::memcpy(frame.data(), begin, frameSize);
+                frames.push_back(std::move(frame));
+                offset += sizeof(frameSize) + frameSize;
+            } else if (sizeof(frameSize) + frameSize > connection.staging.size()) {
+                connection.frame = Frame(frameSize);
+                std::memcpy(connection.frame.data(), begin, available);
+                connection.received = available;
+                offset = connection.staged;
+            } else {
+                break;
+            }
+        }
+
+        std::memmove(
+            connection.staging.data(),
+            connection.staging.data() + offset,
+            connection.staged - offset);
+        connection.staged -= offset;
+    }
+
+    void close()
+    {
+        // Cancels all operations, they refer to the fds below
+        ring.reset();
+
+        for (auto const& connection : connections) {
+            ::close(connection.first);
+        }
+        connections.clear();
+
+        for (auto const& listener : listeners) {
+            closeListener(listener);
+        }
+        listeners.clear();
+
+        if (epollFd >= 0) {
+            ::close(epollFd);
+            epollFd = -1;
+        }
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+};
+
+} // namespace tcp
+
+} // namespace communicationPolicy
+
+} // namespace graybat
@@ -33,6 +33,70 @@ namespace graybat {
                 size_t contextSize;
                 std::string contextName = "context";
                 size_t maxBufferSize = 100 * 1000 * 1000;
+
+                // Send sockets are connected on the first send to a
+                // peer, at most maxSendSockets data and ctrl sockets
+                // each are kept open. 0 keeps all sockets open.
+                size_t maxSendSockets = 0;
+
+                // Peers additionally bind ipc and inproc endpoints in
+                // ipcDir and connect over them to peers on the same
+                // host or in the same process.
+                bool localTransports = true;
+                std::string ipcDir = "/tmp";
+
+                // ZMQ I/O threads of the ZMQ context, which is shared by
+                // all peers of a process and created by the first one
+                int ioThreads = 1;
+
+                // Workers which confirm and deliver received messages,
+                // messages of a source are processed in order. With 0
+                // workers the receiving thread does it by itself.
+                size_t nRecvWorkers = 0;
+
+                // Peer messages to the same peer are batched into a
+                // single frame of up to batchSize bytes, sent when it
+                // is full, after batchTimeoutUs microseconds or on
+                // flush(). A batch size of 0 disables batching.
+                size_t batchSize = 0;
+                size_t batchTimeoutUs = 100;
+
+                // Peer messages of at least rendezvousThreshold bytes
+                // only announce their size. The payload follows once the
+                // receiver posted its buffer and is copied right into
+                // it, thus large messages do not fill up the receive
+                // buffer. A threshold of 0 sends all messages eagerly.
+                size_t rendezvousThreshold = 0;
+
+                // Rendezvous payloads are sent in segments of up to
+                // chunkSize bytes, segments of different messages take
+                // turns. Without a rendezvousThreshold, messages of at
+                // least chunkSize bytes take the rendezvous. A chunk
+                // size of 0 sends payloads in one piece.
+                size_t chunkSize = 0;
+
+                // Rendezvous segments to a peer take turns on nRails
+                // data connections, thus are carried by several TCP
+                // streams. Without a chunk size, payloads are split
+                // evenly over the rails.
+                size_t nRails = 1;
+
+                // Broadcasts are published once on a ZMQ_XPUB socket of
+                // the root and fanned out by ZMQ to the ZMQ_SUB sockets
+                // of all other peers, which subscribe to the context and
+                // tag of the broadcast. The root waits until all peers
+                // of the context subscribed, thus the first broadcast
+                // of a context is not lost.
+                bool publishBroadcasts = false;
+
+                // Tree bootstrap: peers with consecutive bootstrapRank form
+                // groups of bootstrapGroupSize, only the first peer of a
+                // group contacts the signaling server. Peers of a group
+                // meet at an ipc endpoint in bootstrapDir, thus need to
+                // share a node. A group size below 2 disables it.
+                size_t bootstrapGroupSize = 0;
+                size_t bootstrapRank = 0;
+                std::string bootstrapDir = "/tmp";
             };
 
         } // zmq
@@ -0,0 +1,119 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Clib
+#include <unistd.h>
+
+// Stl
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace graybat {
+namespace communicationPolicy {
+namespace zmq {
+
+/**
+ * @brief All endpoints a socket of a peer is bound to.
+ *
+ * The endpoints are published through signaling as a single uri of
+ * the form "tcp;hostId;ipc;processId;inproc". A connecting peer
+ * selects inproc when both peers share the ZMQ context, ipc when
+ * they share the host and tcp otherwise. Plain uris (e.g.
+ * tcp://127.0.0.1:5000) decode to tcp endpoints only.
+ */
+struct Endpoints {
+
+    std::string tcp;
+    std::string hostId;
+    std::string ipc;
+    std::string processId;
+    std::string inproc;
+
+    std::string encode() const
+    {
+        if (hostId.empty()) {
+            return tcp;
+        }
+        return tcp + ";" + hostId + ";" + ipc + ";" + processId + ";" + inproc;
+    }
+
+    static Endpoints decode(std::string const& uri)
+    {
+        Endpoints endpoints;
+        std::istringstream fields(uri);
+        std::getline(fields, endpoints.tcp, ';');
+        std::getline(fields, endpoints.hostId, ';');
+        std::getline(fields, endpoints.ipc, ';');
+        std::getline(fields, endpoints.processId, ';');
+        std::getline(fields, endpoints.inproc, ';');
+        return endpoints;
+    }
+
+    /**
+     * @brief Returns the cheapest endpoint a peer with *local*
+     *        endpoints can connect to.
+     */
+    std::string select(Endpoints const& local) const
+    {
+        const bool sameHost = !hostId.empty() && hostId == local.hostId;
+
+        if (sameHost && !inproc.empty() && processId == local.processId) {
+            return inproc;
+        }
+        if (sameHost && !ipc.empty()) {
+            return ipc;
+        }
+        return tcp;
+    }
+
+    /**
+     * @brief Identifies the host, hostnames may repeat across
+     *        containers, thus the boot id is appended if available.
+     */
+    static std::string localHostId()
+    {
+        char hostname[256] = {};
+        ::gethostname(hostname, sizeof(hostname) - 1);
+        std::string hostId(hostname);
+
+        std::ifstream bootIdFile("/proc/sys/kernel/random/boot_id");
+        std::string bootId;
+        if (bootIdFile >> bootId) {
+            hostId += "-" + bootId;
+        }
+
+        // Uris are separated by whitespace and fields by ';'
+        std::replace_if(
+            hostId.begin(),
+            hostId.end(),
+            [](char c) { return c == ';' || std::isspace(static_cast<unsigned char>(c)); },
+            '_');
+        return hostId;
+    }
+};
+
+} // namespace zmq
+} // namespace communicationPolicy
+} // namespace graybat
@@ -20,7 +20,13 @@
 
 #pragma once
 
+// Stl
+#include <cstring>
+
+// Graybat
 #include <graybat/communicationPolicy/Traits.hpp>
+#include <graybat/communicationPolicy/socket/WireHeader.hpp>
+#include <graybat/utils/BufferPool.hpp>
 
 namespace graybat {
     
@@ -39,12 +45,27 @@ namespace graybat {
                 using MsgType             = typename graybat::communicationPolicy::MsgType<CommunicationPolicy>;
                 using MsgID               = typename graybat::communicationPolicy::MsgID<CommunicationPolicy>;
 
+                // Messages up to this size are stored inside of the
+                // ZMQ message without any allocation
+                static constexpr size_t maxInlineSize = 32;
+
                 // Members
+                socket::WireHeader header;
+                size_t headerSize;
                 ::zmq::message_t message;
 
                 // Methods
-                Message(){
+                Message() : header(), headerSize(0){
+
+                }
 
+                /**
+                 * @brief Copies a complete message, header included,
+                 *        from *frame*.
+                 */
+                Message(const void* frame, size_t const size) : message(pooled(size)){
+                    memcpy (message.data(), frame, size);
+                    decodeHeader();
                 }
                 
                 template <typename T_Data>
@@ -53,71 +74,112 @@ namespace graybat {
                         ContextID const contextID,
                         VAddr const srcVAddr,
                         Tag const tag,      
-                        T_Data & data) : message(sizeof(MsgType) +
-                                                       sizeof(MsgID) +
-                                                       sizeof(ContextID) +
-                                                       sizeof(VAddr) +
-                                                       sizeof(Tag) +
-                                                       data.size() * sizeof(typename T_Data::value_type)){
+                        T_Data & data) : header{msgType, msgID, contextID, srcVAddr, tag},
+                                         headerSize(header.encodedSize()),
+                                         message(pooled(headerSize + data.size() * sizeof(typename T_Data::value_type))){
 
-                    size_t    msgOffset(0);
-                    memcpy (static_cast<char*>(message.data()) + msgOffset, &msgType,    sizeof(MsgType));   msgOffset += sizeof(MsgType);
-                    memcpy (static_cast<char*>(message.data()) + msgOffset, &msgID,      sizeof(MsgID));     msgOffset += sizeof(MsgID);		
-                    memcpy (static_cast<char*>(message.data()) + msgOffset, &contextID,  sizeof(ContextID)); msgOffset += sizeof(ContextID);
-                    memcpy (static_cast<char*>(message.data()) + msgOffset, &srcVAddr,   sizeof(VAddr));     msgOffset += sizeof(VAddr);
-                    memcpy (static_cast<char*>(message.data()) + msgOffset, &tag,        sizeof(Tag));       msgOffset += sizeof(Tag);
-                    memcpy (static_cast<char*>(message.data()) + msgOffset, data.data(), sizeof(typename T_Data::value_type) * data.size());
+                    header.encode(static_cast<std::int8_t*>(message.data()));
+                    memcpy (static_cast<char*>(message.data()) + headerSize, data.data(), sizeof(typename T_Data::value_type) * data.size());
 
                 }
 
-                MsgType getMsgType(){
-                    MsgType msgType;
-                    memcpy (&msgType, static_cast<char*>(message.data()), sizeof(MsgType));
-                    return msgType;
+                /**
+                 * @brief Creates a message with room for *dataSize*
+                 *        bytes of payload, to be filled via getData().
+                 */
+                Message(MsgType const msgType,
+                        MsgID const msgID,
+                        ContextID const contextID,
+                        VAddr const srcVAddr,
+                        Tag const tag,
+                        size_t const dataSize) : header{msgType, msgID, contextID, srcVAddr, tag},
+                                                 headerSize(header.encodedSize()),
+                                                 message(pooled(headerSize + dataSize)){
 
-                    
+                    header.encode(static_cast<std::int8_t*>(message.data()));
+
+                }
+
+                /**
+                 * @brief Decodes the header of a received message,
+                 *        needs to be called once after the message
+                 *        was filled by a socket.
+                 */
+                void decodeHeader(){
+                    headerSize = header.decode(static_cast<std::int8_t*>(message.data()), message.size());
+                }
+
+                MsgType getMsgType(){
+                    return header.msgType;
                 }
 
                 MsgID getMsgID(){
-                    MsgID   msgID;
-                    memcpy (&msgID, static_cast<char*>(message.data()) + sizeof(MsgType), sizeof(MsgID));
-                    return msgID;
-                    
+                    return header.msgID;
                 }
 
                 ContextID getContextID(){
-                    ContextID contextID;
-                    memcpy (&contextID, static_cast<char*>(message.data()) + sizeof(MsgType) + sizeof(MsgID), sizeof(ContextID));
-                    return contextID;
-                    
+                    return header.contextID;
                 }
 
                 VAddr getVAddr(){
-                    VAddr vAddr;
-                    memcpy (&vAddr, static_cast<char*>(message.data()) + sizeof(MsgType) + sizeof(MsgID) + sizeof(ContextID), sizeof(VAddr));
-                    return vAddr;
-
+                    return header.vAddr;
                 }
 
                 Tag getTag(){
-                    Tag tag;
-                    memcpy (&tag, static_cast<char*>(message.data()) + sizeof(MsgType) + sizeof(MsgID) + sizeof(ContextID) + sizeof(VAddr), sizeof(Tag));
-                    return tag;
-
+                    return header.tag;
                 }
-		
+
+                /**
+                 * @brief Size of the payload in bytes.
+                 */
 		size_t size() {
-		    return message.size();
+		    return message.size() - headerSize;
 		}
 
+                /**
+                 * @brief Size of the data the message delivers, for
+                 *        a request to send the size it announces.
+                 */
+                size_t getDataSize() {
+                    if (header.msgType == MsgType::REQUEST_TO_SEND) {
+                        std::uint64_t dataSize = 0;
+                        memcpy (&dataSize, getData(), sizeof(dataSize));
+                        return dataSize;
+                    }
+                    return size();
+                }
+
                 std::int8_t* getData(){
-                    return static_cast<std::int8_t*>(message.data()) + sizeof(MsgType) + sizeof(MsgID) + sizeof(ContextID) + sizeof(VAddr) + sizeof(Tag);
+                    return static_cast<std::int8_t*>(message.data()) + headerSize;
                     
                 }
                 
                 ::zmq::message_t& getMessage(){
                     return message;
                 }
+
+                /**
+                 * @brief ZMQ message of *size* bytes in a buffer of
+                 *        the BufferPool, which ZMQ releases once sent.
+                 *        ZMQ keeps small messages inline anyway.
+                 */
+                static ::zmq::message_t pooled(size_t const size){
+                    if (size <= maxInlineSize) {
+                        return ::zmq::message_t(size);
+                    }
+                    return ::zmq::message_t(utils::BufferPool::instance().allocate(size), size, &utils::BufferPool::release);
+                }
+
+                std::int8_t* getFrame(){
+                    return static_cast<std::int8_t*>(message.data());
+                }
+
+                /**
+                 * @brief Size of the complete message, header included.
+                 */
+                size_t getFrameSize(){
+                    return message.size();
+                }
                 
             };
 
@@ -38,6 +38,10 @@
   #include <graybat/communicationPolicy/BMPI.hpp>
 #endif
 
+#ifdef graybat_TCP_CP_ENABLED
+  #include <graybat/communicationPolicy/TCP.hpp>
+#endif
+
 // Mappings
 #include <graybat/mapping/Consecutive.hpp>
 #include <graybat/mapping/Filter.hpp>
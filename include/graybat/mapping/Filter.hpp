@@ -46,6 +46,7 @@ struct Filter {
         using Vertex = typename T_Cage::Vertex;
         using Context = typename CommunicationPolicy::Context;
         using VAddr = typename CommunicationPolicy::VAddr;
+        using Event = typename CommunicationPolicy::Event;
 
         boost::ignore_unused(processID);
         boost::ignore_unused(processCount);
@@ -58,8 +59,9 @@ struct Filter {
         // Get the information about who wants to
         // host vertices with the same tag
         std::array<size_t, 1> sendData{ vertexTag };
+        std::vector<Event> events;
         for (auto const& vAddr : context) {
-            comm->asyncSend(vAddr, 0, context, sendData);
+            events.push_back(comm->asyncSend(vAddr, 0, context, sendData));
         }
 
         for (auto const& vAddr : context) {
@@ -70,6 +72,10 @@ struct Filter {
             }
         }
 
+        for (Event& e : events) {
+            e.wait();
+        }
+
         // Distribute vertices to peers with same tag
         std::sort(peersWithSameTag.begin(), peersWithSameTag.end());
 
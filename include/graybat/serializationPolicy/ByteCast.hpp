@@ -23,18 +23,23 @@
 #include <boost/optional.hpp>
 #include <memory>
 #include <sstream>
+#include <vector>
+
+#include <graybat/utils/BufferPool.hpp>
 
 namespace graybat {
 namespace serializationPolicy {
 
 namespace {
 /// models concept::ResizeableContainer
+/// bytes and bookkeeping are recycled by the utils::BufferPool
 class BytePack {
   public:
     using value_type = uint8_t;
+    using Bytes = std::vector<value_type, utils::PoolAllocator<value_type>>;
 
-    BytePack(const std::shared_ptr<std::vector<value_type>>& ptr)
-        : ptr(ptr)
+    BytePack(std::size_t size)
+        : ptr(std::allocate_shared<Bytes>(utils::PoolAllocator<Bytes>(), size))
     {
     }
 
@@ -54,7 +59,7 @@ class BytePack {
     }
 
   private:
-    std::shared_ptr<std::vector<value_type>> ptr;
+    std::shared_ptr<Bytes> ptr;
 };
 }
 
@@ -66,7 +71,7 @@ class ByteCast {
     /// requires concept::ContiguousContainer<T>
     template <typename T> auto static serialize(T const& data) -> BytePack
     {
-        BytePack bytes{ std::make_shared<std::vector<uint8_t>>(sizeInBytes(data)) };
+        BytePack bytes(sizeInBytes(data));
         std::memcpy(bytes.data(), data.data(), sizeInBytes(data));
         return bytes;
     }
@@ -74,7 +79,7 @@ class ByteCast {
     /// requires concept::ContiguousContainer<T>
     template <typename T> auto static prepare(T const& data) -> BytePack
     {
-        return BytePack(std::make_shared<std::vector<uint8_t>>(sizeInBytes(data)));
+        return BytePack(sizeInBytes(data));
     }
 
     /// requires concept::ContiguousContainer<T>
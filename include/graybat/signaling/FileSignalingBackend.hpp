@@ -0,0 +1,328 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Clib
+#include <dirent.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Stl
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Graybat
+#include <graybat/signaling/GrpcSignalingTypes.hpp>
+#include <graybat/signaling/SignalingBackend.hpp>
+
+namespace graybat {
+namespace signaling {
+
+/**
+ * @brief Signaling through a directory shared by all peers, no
+ *        signaling server is needed.
+ *
+ * Every record is a file which is written under a temporary name
+ * and published by a hard link to its final name. Linking fails
+ * when the name already exists, thus the first peer wins and
+ * readers never see partially written files. A directory in
+ * /dev/shm keeps all records in shared memory.
+ *
+ * Layout of the directory:
+ *   context-<name>    id of the context with <name>
+ *   id-<id>           claims <id> for a context
+ *   <id>/<vaddr>      data and ctrl uri of a peer
+ *   <id>/.joined-<n>  n-th peer which requested the context
+ *   <id>/.left-<n>    n-th peer which left the context
+ *
+ * The first peer to leave a context frees its name, the last one
+ * removes <id>/ and id-<id>. Peers which crash leave their records
+ * behind, thus each job should use a directory of its own.
+ */
+class FileSignalingBackend final : public SignalingBackend {
+  public:
+    explicit FileSignalingBackend(const std::string& directory)
+        : directory_(directory)
+    {
+        makeDirectory(directory_);
+    }
+
+    ContextId requestContext(const ContextName& contextName) override;
+
+    Vaddr requestVaddr(ContextId contextId, const Uri& dataUri, const Uri& ctrlUri) override;
+
+    std::pair<Uri, Uri> lookupVaddr(ContextId contextId, Vaddr vaddr) override;
+
+    std::vector<std::pair<Uri, Uri>>
+    lookupContext(ContextId contextId, std::size_t contextSize) override;
+
+    void leaveContext(const ContextName& contextName) override;
+
+  private:
+    std::string contextPath(const ContextName& contextName) const;
+
+    std::string peerDirectory(ContextId contextId) const;
+
+    /**
+     * @brief Creates the file *path* with *content*.
+     *
+     * @return false when *path* already exists
+     */
+    bool publish(const std::string& path, const std::string& content) const;
+
+    static bool read(const std::string& path, std::string& content);
+
+    static void makeDirectory(const std::string& path);
+
+    static std::size_t countEntries(const std::string& path);
+
+    /**
+     * @brief Creates the first free file of *prefix*0, *prefix*1, ...
+     *
+     * @return number of the created file
+     */
+    std::size_t claim(const std::string& prefix) const;
+
+    static void removeDirectory(const std::string& path);
+
+    const std::string directory_;
+
+    // Contexts this peer requested and did not leave yet
+    std::map<ContextName, ContextId> joinedContexts_;
+};
+
+inline ContextId FileSignalingBackend::requestContext(const ContextName& contextName)
+{
+    const std::string path = contextPath(contextName);
+    std::string content;
+
+    while (!read(path, content)) {
+        // Claim an unused id and try to bind the name to it,
+        // peers which loose the race read the id of the winner
+        const std::string idPath = directory_ + "/id-";
+        const std::size_t contextId = claim(idPath);
+        if (!publish(path, std::to_string(contextId))) {
+            ::unlink((idPath + std::to_string(contextId)).c_str());
+        }
+    }
+
+    const ContextId contextId = static_cast<ContextId>(std::stoul(content));
+
+    // Joins are counted once per peer, thus the last
+    // peer to leave knows that it is the last one
+    if (joinedContexts_.find(contextName) == joinedContexts_.end()) {
+        makeDirectory(peerDirectory(contextId));
+        claim(peerDirectory(contextId) + "/.joined-");
+        joinedContexts_[contextName] = contextId;
+    }
+
+    return contextId;
+}
+
+inline Vaddr
+FileSignalingBackend::requestVaddr(ContextId contextId, const Uri& dataUri, const Uri& ctrlUri)
+{
+    const std::string directory = peerDirectory(contextId);
+    makeDirectory(directory);
+
+    // Vaddrs are taken without gaps, thus the number of
+    // entries is the first vaddr which may be free
+    Vaddr vaddr = countEntries(directory);
+    while (!publish(directory + "/" + std::to_string(vaddr), dataUri + " " + ctrlUri)) {
+        vaddr++;
+    }
+
+    return vaddr;
+}
+
+inline std::pair<Uri, Uri> FileSignalingBackend::lookupVaddr(ContextId contextId, Vaddr vaddr)
+{
+    const std::string path = peerDirectory(contextId) + "/" + std::to_string(vaddr);
+    std::string content;
+
+    std::chrono::microseconds backoff(100);
+    while (!read(path, content)) {
+        std::this_thread::sleep_for(backoff);
+        backoff = std::min(2 * backoff, std::chrono::microseconds(10000));
+    }
+
+    Uri dataUri;
+    Uri ctrlUri;
+    std::istringstream(content) >> dataUri >> ctrlUri;
+    return std::make_pair(dataUri, ctrlUri);
+}
+
+inline std::vector<std::pair<Uri, Uri>>
+FileSignalingBackend::lookupContext(ContextId contextId, std::size_t contextSize)
+{
+    std::vector<std::pair<Uri, Uri>> uris;
+    for (Vaddr vaddr = 0; vaddr < contextSize; ++vaddr) {
+        uris.push_back(lookupVaddr(contextId, vaddr));
+    }
+    return uris;
+}
+
+inline void FileSignalingBackend::leaveContext(const ContextName& contextName)
+{
+    // Peers leave one after the other, only the first unlink succeeds
+    ::unlink(contextPath(contextName).c_str());
+
+    auto joined = joinedContexts_.find(contextName);
+    if (joined == joinedContexts_.end()) {
+        return;
+    }
+    const ContextId contextId = joined->second;
+    joinedContexts_.erase(joined);
+
+    // All peers joined before the first one left, the peer
+    // which takes the leave of the last join removes the records
+    const std::string directory = peerDirectory(contextId);
+    const std::size_t nLeft = claim(directory + "/.left-") + 1;
+    std::string content;
+    if (read(directory + "/.joined-" + std::to_string(nLeft), content)) {
+        return;
+    }
+    removeDirectory(directory);
+    ::unlink((directory_ + "/id-" + std::to_string(contextId)).c_str());
+}
+
+inline std::string FileSignalingBackend::contextPath(const ContextName& contextName) const
+{
+    // Context names may contain slashes
+    std::string escaped;
+    for (char c : contextName) {
+        if (c == '/' || c == '%') {
+            escaped += c == '/' ? "%2F" : "%25";
+        } else {
+            escaped += c;
+        }
+    }
+    return directory_ + "/context-" + escaped;
+}
+
+inline std::string FileSignalingBackend::peerDirectory(ContextId contextId) const
+{
+    return directory_ + "/" + std::to_string(contextId);
+}
+
+inline bool FileSignalingBackend::publish(const std::string& path, const std::string& content) const
+{
+    static std::atomic<unsigned> nTmpFiles(0);
+    const std::string tmpPath = directory_ + "/.tmp-" + std::to_string(::getpid()) + "-"
+        + std::to_string(nTmpFiles++);
+
+    {
+        std::ofstream tmpFile(tmpPath, std::ios::trunc);
+        tmpFile << content;
+        if (!tmpFile) {
+            throw std::runtime_error("File signaling: can not write " + tmpPath);
+        }
+    }
+
+    const bool published = ::link(tmpPath.c_str(), path.c_str()) == 0;
+    const int error = errno;
+    ::unlink(tmpPath.c_str());
+
+    if (!published && error != EEXIST) {
+        throw std::runtime_error(
+            "File signaling: can not create " + path + ": " + ::strerror(error));
+    }
+    return published;
+}
+
+inline bool FileSignalingBackend::read(const std::string& path, std::string& content)
+{
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+inline void FileSignalingBackend::makeDirectory(const std::string& path)
+{
+    for (std::size_t end = path.find('/', 1); ; end = path.find('/', end + 1)) {
+        const std::string prefix = path.substr(0, end);
+        if (::mkdir(prefix.c_str(), 0777) != 0 && errno != EEXIST) {
+            const int error = errno;
+            throw std::runtime_error(
+                "File signaling: can not create directory " + prefix + ": " + ::strerror(error));
+        }
+        if (end == std::string::npos) {
+            break;
+        }
+    }
+}
+
+inline std::size_t FileSignalingBackend::countEntries(const std::string& path)
+{
+    std::size_t nEntries = 0;
+    DIR* directory = ::opendir(path.c_str());
+    if (directory) {
+        while (dirent* entry = ::readdir(directory)) {
+            if (entry->d_name[0] != '.') {
+                nEntries++;
+            }
+        }
+        ::closedir(directory);
+    }
+    return nEntries;
+}
+
+inline std::size_t FileSignalingBackend::claim(const std::string& prefix) const
+{
+    std::size_t n = 0;
+    while (!publish(prefix + std::to_string(n), "")) {
+        n++;
+    }
+    return n;
+}
+
+inline void FileSignalingBackend::removeDirectory(const std::string& path)
+{
+    DIR* directory = ::opendir(path.c_str());
+    if (directory) {
+        while (dirent* entry = ::readdir(directory)) {
+            const std::string name = entry->d_name;
+            if (name != "." && name != "..") {
+                ::unlink((path + "/" + name).c_str());
+            }
+        }
+        ::closedir(directory);
+    }
+    ::rmdir(path.c_str());
+}
+
+} // namespace signaling
+} // namespace graybat
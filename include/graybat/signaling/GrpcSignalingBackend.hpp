@@ -0,0 +1,138 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Stl
+#include <string>
+#include <utility>
+#include <vector>
+
+// Graybat
+#include <graybat/signaling/GrpcSignalingClient.hpp>
+#include <graybat/signaling/GrpcSignalingTypes.hpp>
+#include <graybat/signaling/SignalingBackend.hpp>
+
+namespace graybat {
+namespace signaling {
+
+/**
+ * @brief Signaling through the grpc signaling server.
+ */
+class GrpcSignalingBackend final : public SignalingBackend {
+  public:
+    GrpcSignalingBackend(const Uri& serverUri)
+        : signalingClient_(serverUri)
+    {
+    }
+
+    ContextId requestContext(const ContextName& contextName) override;
+
+    Vaddr requestVaddr(ContextId contextId, const Uri& dataUri, const Uri& ctrlUri) override;
+
+    std::pair<Uri, Uri> lookupVaddr(ContextId contextId, Vaddr vaddr) override;
+
+    std::vector<std::pair<Uri, Uri>>
+    lookupContext(ContextId contextId, std::size_t contextSize) override;
+
+    void leaveContext(const ContextName& contextName) override;
+
+  private:
+    GrpcSignalingClient signalingClient_;
+};
+
+inline ContextId GrpcSignalingBackend::requestContext(const ContextName& contextName)
+{
+    ContextRequest request;
+    ContextReply reply;
+    request.set_context_name(contextName);
+
+    signalingClient_.RequestContext(request, &reply);
+
+    return reply.context_id();
+}
+
+inline Vaddr
+GrpcSignalingBackend::requestVaddr(ContextId contextId, const Uri& dataUri, const Uri& ctrlUri)
+{
+    VaddrRequest request;
+    VaddrReply reply;
+
+    request.set_context_id(contextId);
+    request.set_data_uri(dataUri);
+    request.set_ctrl_uri(ctrlUri);
+
+    signalingClient_.RequestVaddr(request, &reply);
+
+    return reply.vaddr();
+}
+
+inline std::pair<Uri, Uri> GrpcSignalingBackend::lookupVaddr(ContextId contextId, Vaddr vaddr)
+{
+    VaddrLookup request;
+    UriReply reply;
+    request.set_context_id(contextId);
+    request.set_vaddr(vaddr);
+
+    Uri ctrlUri{ "" };
+    Uri dataUri{ "" };
+
+    while (dataUri == "") {
+        signalingClient_.LookupVaddr(request, &reply);
+
+        dataUri = reply.data_uri();
+        ctrlUri = reply.ctrl_uri();
+    }
+    return std::make_pair(dataUri, ctrlUri);
+}
+
+inline std::vector<std::pair<Uri, Uri>>
+GrpcSignalingBackend::lookupContext(ContextId contextId, std::size_t contextSize)
+{
+    ContextLookup request;
+    ContextUriReply reply;
+    request.set_context_id(contextId);
+    request.set_context_size(contextSize);
+
+    // The server replies an empty table when not all peers
+    // registered within its long poll timeout
+    while (static_cast<std::size_t>(reply.data_uris_size()) < contextSize) {
+        reply.Clear();
+        signalingClient_.LookupContext(request, &reply);
+    }
+
+    std::vector<std::pair<Uri, Uri>> uris;
+    for (std::size_t vaddr = 0; vaddr < contextSize; ++vaddr) {
+        uris.emplace_back(reply.data_uris(vaddr), reply.ctrl_uris(vaddr));
+    }
+    return uris;
+}
+
+inline void GrpcSignalingBackend::leaveContext(const ContextName& contextName)
+{
+    LeaveRequest request;
+    LeaveReply reply;
+    request.set_context_name(contextName);
+
+    signalingClient_.LeaveContext(request, &reply);
+}
+
+} // namespace signaling
+} // namespace graybat
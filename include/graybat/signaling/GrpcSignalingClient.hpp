@@ -56,6 +56,8 @@ class GrpcSignalingClient {
 
     bool LookupVaddr(const VaddrLookup& request, UriReply* reply);
 
+    bool LookupContext(const ContextLookup& request, ContextUriReply* reply);
+
     bool LeaveContext(const LeaveRequest& request, LeaveReply* reply);
 
   private:
@@ -89,6 +91,15 @@ inline bool GrpcSignalingClient::LookupVaddr(const VaddrLookup& request, UriRepl
     return checkStatus(status);
 }
 
+inline bool
+GrpcSignalingClient::LookupContext(const ContextLookup& request, ContextUriReply* reply)
+{
+    ClientContext context;
+    auto status = stub_->LookupContext(&context, request, reply);
+
+    return checkStatus(status);
+}
+
 inline bool GrpcSignalingClient::LeaveContext(const LeaveRequest& request, LeaveReply* reply)
 {
     ClientContext context;
@@ -21,8 +21,12 @@
 #pragma once
 
 // Stl
+#include <atomic>
+#include <chrono>
+#include <iostream>
 #include <map>
 #include <mutex>
+#include <sstream>
 
 // Boost
 #include <boost/core/ignore_unused.hpp>
@@ -33,16 +37,62 @@
 
 // Graybat
 #include <graybat/signaling/GrpcSignalingTypes.hpp>
+#include <graybat/signaling/ShardedPhoneBook.hpp>
 
 namespace graybat {
 
 namespace signaling {
 
+/**
+ * @brief Decides lock free which events of a kind are logged,
+ *        every *every*-th event is logged, 0 disables logging.
+ */
+class SampledLog {
+  public:
+    explicit SampledLog(unsigned every)
+        : every_(every)
+        , count_(0)
+    {
+    }
+
+    bool sample()
+    {
+        return every_ != 0 && count_.fetch_add(1, std::memory_order_relaxed) % every_ == 0;
+    }
+
+    /**
+     * @brief Writes a complete line at once, thus lines of
+     *        concurrent requests do not interleave.
+     */
+    static void write(const std::ostringstream& line)
+    {
+        std::cout << line.str() + "\n" << std::flush;
+    }
+
+  private:
+    const unsigned every_;
+    std::atomic<unsigned long> count_;
+};
+
+/**
+ * @brief Signaling service of the grpc signaling server.
+ *
+ * Vaddr registration and uri lookups are the hot path during
+ * startup of large jobs. Their state lives in a ShardedPhoneBook,
+ * lookups never block and registrations only contend with
+ * registrations of contexts on the same shard. Context names
+ * change rarely and share a single mutex. Lines of the hot path
+ * are only logged for every *logEvery*-th request and never while
+ * holding a lock.
+ */
 struct GrpcSignalingService final : public Signaling::Service {
 
-    GrpcSignalingService()
+    explicit GrpcSignalingService(unsigned logEvery = 100)
         : maxContextId_(0)
         , maxInitialContextId_(0)
+        , vaddrRequestLog_(logEvery)
+        , vaddrLookupLog_(logEvery)
+        , contextLookupLog_(logEvery)
     {
     }
 
@@ -59,38 +109,54 @@ struct GrpcSignalingService final : public Signaling::Service {
     grpc::Status LookupVaddr(
         grpc::ServerContext* context, const VaddrLookup* request, UriReply* response) override;
 
+    /**
+     * @brief Blocks until context_size peers registered in the context
+     *        and replies the uris of all of them at once. Replies an
+     *        empty table after a timeout, thus clients retry.
+     */
+    grpc::Status LookupContext(
+        grpc::ServerContext* context,
+        const ContextLookup* request,
+        ContextUriReply* response) override;
+
     grpc::Status LeaveContext(
         grpc::ServerContext* context, const LeaveRequest* request, LeaveReply* response) override;
 
   private:
-    std::mutex mtx_;
-    std::map<ContextId, std::map<Vaddr, Uri>> phoneBook_;
-    std::map<ContextId, std::map<Vaddr, Uri>> ctrlPhoneBook_;
-    std::map<ContextId, Vaddr> maxVAddr_;
-    std::map<ContextId, std::vector<Uri>> peers_;
+    std::mutex contextMtx_;
     std::map<ContextName, ContextId> contextIds_;
     ContextId maxContextId_;
     ContextId maxInitialContextId_;
+
+    ShardedPhoneBook phoneBook_;
+
+    SampledLog vaddrRequestLog_;
+    SampledLog vaddrLookupLog_;
+    SampledLog contextLookupLog_;
 };
 
 inline grpc::Status GrpcSignalingService::RequestContext(
     grpc::ServerContext*, const ContextRequest* request, ContextReply* response)
 {
-    std::lock_guard<std::mutex> lock(mtx_);
     std::string contextName = request->context_name();
     ContextId contextId = 0;
 
-    if (contextIds_.find(contextName) != contextIds_.end()) {
-        response->set_context_id(contextIds_.at(contextName));
-        contextId = contextIds_.at(contextName);
-    } else {
-        contextId = maxContextId_;
-        response->set_context_id(contextId);
-        contextIds_[contextName] = contextId;
-        maxContextId_++;
+    {
+        std::lock_guard<std::mutex> lock(contextMtx_);
+        if (contextIds_.find(contextName) != contextIds_.end()) {
+            contextId = contextIds_.at(contextName);
+        } else {
+            contextId = maxContextId_;
+            contextIds_[contextName] = contextId;
+            maxContextId_++;
+        }
     }
 
-    std::cout << "CONTEXT REQUEST [name:" << contextName << "]: " << contextId << std::endl;
+    response->set_context_id(contextId);
+
+    std::ostringstream line;
+    line << "CONTEXT REQUEST [name:" << contextName << "]: " << contextId;
+    SampledLog::write(line);
 
     return grpc::Status::OK;
 }
@@ -98,21 +164,23 @@ inline grpc::Status GrpcSignalingService::RequestContext(
 inline grpc::Status GrpcSignalingService::RequestVaddr(
     ::grpc::ServerContext*, const ::VaddrRequest* request, ::VaddrReply* response)
 {
-    std::lock_guard<std::mutex> lock(mtx_);
     ContextId contextId = request->context_id();
     Uri dataUri = request->data_uri();
     Uri ctrlUri = request->ctrl_uri();
 
-    peers_[contextId].push_back(dataUri);
-    Vaddr vAddr = peers_[contextId].size() - 1;
-
-    phoneBook_[contextId][vAddr] = dataUri;
-    ctrlPhoneBook_[contextId][vAddr] = ctrlUri;
+    Vaddr vAddr = 0;
+    if (!phoneBook_.insert(contextId, dataUri, ctrlUri, vAddr)) {
+        return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "Context is full");
+    }
 
     response->set_vaddr(vAddr);
 
-    std::cout << "VADDR REQUEST [contextID:" << contextId << "][srcUri:" << dataUri << "]"
-              << "[ctrlUri:" << ctrlUri << "]:" << vAddr << std::endl;
+    if (vaddrRequestLog_.sample()) {
+        std::ostringstream line;
+        line << "VADDR REQUEST [contextID:" << contextId << "][srcUri:" << dataUri << "]"
+             << "[ctrlUri:" << ctrlUri << "]:" << vAddr;
+        SampledLog::write(line);
+    }
 
     return grpc::Status::OK;
 }
@@ -123,16 +191,52 @@ inline grpc::Status GrpcSignalingService::LookupVaddr(
     ContextId contextId = request->context_id();
     Vaddr vaddr = request->vaddr();
 
-    if (phoneBook_[contextId].count(vaddr) == 0) {
-        std::cout << "VADDR LOOKUP [contextID:" << contextId << "][remoteVAddr:" << vaddr << "]: "
-                  << " RETRY " << std::endl;
-    } else {
-        response->set_data_uri(phoneBook_[contextId][vaddr]);
-        response->set_ctrl_uri(ctrlPhoneBook_[contextId][vaddr]);
+    std::shared_ptr<const ContextBook> book = phoneBook_.find(contextId);
+    const bool registered = book && vaddr < book->size();
 
-        std::cout << "VADDR LOOKUP [contextID:" << contextId << "][remoteVAddr:" << vaddr
-                  << "]: " << phoneBook_[contextId][vaddr] << " "
-                  << ctrlPhoneBook_[contextId][vaddr] << std::endl;
+    if (registered) {
+        response->set_data_uri(book->at(vaddr).dataUri);
+        response->set_ctrl_uri(book->at(vaddr).ctrlUri);
+    }
+
+    if (vaddrLookupLog_.sample()) {
+        std::ostringstream line;
+        line << "VADDR LOOKUP [contextID:" << contextId << "][remoteVAddr:" << vaddr << "]: ";
+        if (registered) {
+            line << response->data_uri() << " " << response->ctrl_uri();
+        } else {
+            line << " RETRY ";
+        }
+        SampledLog::write(line);
+    }
+
+    return grpc::Status::OK;
+}
+
+inline grpc::Status GrpcSignalingService::LookupContext(
+    ::grpc::ServerContext* context, const ::ContextLookup* request, ::ContextUriReply* response)
+{
+    ContextId contextId = request->context_id();
+    std::size_t contextSize = request->context_size();
+
+    std::shared_ptr<const ContextBook> book = phoneBook_.waitFor(
+        contextId,
+        contextSize,
+        std::chrono::steady_clock::now() + std::chrono::seconds(10),
+        [context]() { return context->IsCancelled(); });
+
+    if (book) {
+        for (Vaddr vaddr = 0; vaddr < contextSize; ++vaddr) {
+            response->add_data_uris(book->at(vaddr).dataUri);
+            response->add_ctrl_uris(book->at(vaddr).ctrlUri);
+        }
+    }
+
+    if (contextLookupLog_.sample()) {
+        std::ostringstream line;
+        line << "CONTEXT LOOKUP [contextID:" << contextId << "][contextSize:" << contextSize
+             << "]: " << response->data_uris_size() << " uris";
+        SampledLog::write(line);
     }
 
     return grpc::Status::OK;
@@ -141,16 +245,20 @@ inline grpc::Status GrpcSignalingService::LookupVaddr(
 inline grpc::Status
 GrpcSignalingService::LeaveContext(grpc::ServerContext*, const LeaveRequest* request, LeaveReply*)
 {
-    std::lock_guard<std::mutex> lock(mtx_);
     std::string contextName = request->context_name();
 
-    auto it = contextIds_.find(contextName);
+    {
+        std::lock_guard<std::mutex> lock(contextMtx_);
+        auto it = contextIds_.find(contextName);
 
-    if (it != contextIds_.end()) {
-        contextIds_.erase(it);
+        if (it != contextIds_.end()) {
+            contextIds_.erase(it);
+        }
     }
 
-    std::cout << "LEAVE CONTEXT [contextName:" << contextName << "]" << std::endl;
+    std::ostringstream line;
+    line << "LEAVE CONTEXT [contextName:" << contextName << "]";
+    SampledLog::write(line);
 
     return grpc::Status::OK;
 }
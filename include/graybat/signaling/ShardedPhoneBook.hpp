@@ -0,0 +1,250 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Stl
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Graybat
+#include <graybat/signaling/GrpcSignalingTypes.hpp>
+
+namespace graybat {
+
+namespace signaling {
+
+/**
+ * @brief Append-only table of the uris of all peers of a context.
+ *
+ * Writers are serialized by the owner of the book, readers are
+ * lock free. An entry is written before the size is published with
+ * release semantics, thus every entry below an acquired size is
+ * complete and never changes again. Entries live in fixed-size
+ * chunks which are never moved.
+ */
+class ContextBook {
+  public:
+    struct Entry {
+        Uri dataUri;
+        Uri ctrlUri;
+    };
+
+    static constexpr std::size_t chunkSize = 1024;
+    static constexpr std::size_t maxChunks = 1024;
+    static constexpr std::size_t capacity = chunkSize * maxChunks;
+
+    ContextBook()
+        : size_(0)
+    {
+        for (auto& chunk : chunks_) {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ContextBook(const ContextBook&) = delete;
+    ContextBook& operator=(const ContextBook&) = delete;
+
+    ~ContextBook()
+    {
+        for (auto& chunk : chunks_) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Appends the uris of a peer and returns its vaddr.
+     *        Must not be called concurrently and not on a full book.
+     */
+    Vaddr append(const Uri& dataUri, const Uri& ctrlUri)
+    {
+        const std::size_t vaddr = size_.load(std::memory_order_relaxed);
+        std::atomic<Entry*>& chunk = chunks_[vaddr / chunkSize];
+
+        if (chunk.load(std::memory_order_relaxed) == nullptr) {
+            chunk.store(new Entry[chunkSize], std::memory_order_relaxed);
+        }
+
+        Entry& entry = chunk.load(std::memory_order_relaxed)[vaddr % chunkSize];
+        entry.dataUri = dataUri;
+        entry.ctrlUri = ctrlUri;
+
+        size_.store(vaddr + 1, std::memory_order_release);
+        return static_cast<Vaddr>(vaddr);
+    }
+
+    std::size_t size() const
+    {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    bool full() const
+    {
+        return size() == capacity;
+    }
+
+    /**
+     * @brief Entry of a peer, vaddr needs to be below a
+     *        previously read size().
+     */
+    const Entry& at(Vaddr vaddr) const
+    {
+        return chunks_[vaddr / chunkSize].load(std::memory_order_relaxed)[vaddr % chunkSize];
+    }
+
+  private:
+    std::array<std::atomic<Entry*>, maxChunks> chunks_;
+    std::atomic<std::size_t> size_;
+};
+
+/**
+ * @brief Phone books of all contexts, sharded by context id.
+ *
+ * Each shard publishes an immutable map from context id to context
+ * book, readers take a snapshot of it with std::atomic_load and
+ * never block. Writers of a shard are serialized by its mutex and
+ * only copy the map when a new context shows up. Peers of different
+ * contexts register on different shards without contention.
+ */
+class ShardedPhoneBook {
+  public:
+    static constexpr std::size_t nShards = 64;
+
+    /**
+     * @brief Book of a context or nullptr when no peer registered
+     *        in the context yet.
+     */
+    std::shared_ptr<const ContextBook> find(ContextId contextId) const
+    {
+        std::shared_ptr<const BookMap> books = std::atomic_load(&shardOf(contextId).books);
+        if (!books) {
+            return nullptr;
+        }
+
+        auto it = books->find(contextId);
+        return it == books->end() ? nullptr : it->second;
+    }
+
+    /**
+     * @brief Registers the uris of a peer in a context and wakes up
+     *        peers waiting for the context to fill up.
+     *
+     * @return true and the vaddr of the peer in *vaddr* or false
+     *         when the context reached its capacity.
+     */
+    bool insert(ContextId contextId, const Uri& dataUri, const Uri& ctrlUri, Vaddr& vaddr)
+    {
+        Shard& shard = shardOf(contextId);
+        {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            std::shared_ptr<ContextBook> book = findOrCreate(shard, contextId);
+            if (book->full()) {
+                return false;
+            }
+            vaddr = book->append(dataUri, ctrlUri);
+        }
+        shard.registered.notify_all();
+        return true;
+    }
+
+    /**
+     * @brief Blocks until *contextSize* peers registered in a context,
+     *        the deadline passed or *cancelled* returns true.
+     *
+     * @return The book of the context when it is complete,
+     *         otherwise nullptr.
+     */
+    template <typename T_Cancelled>
+    std::shared_ptr<const ContextBook> waitFor(
+        ContextId contextId,
+        std::size_t contextSize,
+        std::chrono::steady_clock::time_point deadline,
+        T_Cancelled cancelled) const
+    {
+        auto complete = [this, contextId, contextSize]() {
+            std::shared_ptr<const ContextBook> book = find(contextId);
+            return (book && book->size() >= contextSize) ? book : nullptr;
+        };
+
+        std::shared_ptr<const ContextBook> book = complete();
+        if (book) {
+            return book;
+        }
+
+        // Slow path, wake up now and then to notice cancellation
+        Shard& shard = shardOf(contextId);
+        std::unique_lock<std::mutex> lock(shard.mtx);
+        while (!(book = complete()) && !cancelled()) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                break;
+            }
+            shard.registered.wait_for(lock, std::min<std::chrono::steady_clock::duration>(
+                                                deadline - now, std::chrono::seconds(1)));
+        }
+        return book;
+    }
+
+  private:
+    using BookMap = std::map<ContextId, std::shared_ptr<ContextBook>>;
+
+    struct Shard {
+        std::mutex mtx;
+        std::condition_variable registered;
+        std::shared_ptr<const BookMap> books;
+    };
+
+    Shard& shardOf(ContextId contextId) const
+    {
+        return shards_[contextId % nShards];
+    }
+
+    static std::shared_ptr<ContextBook> findOrCreate(Shard& shard, ContextId contextId)
+    {
+        std::shared_ptr<const BookMap> books = std::atomic_load(&shard.books);
+        if (books) {
+            auto it = books->find(contextId);
+            if (it != books->end()) {
+                return it->second;
+            }
+        }
+
+        // Copy on write, readers keep their snapshot
+        std::shared_ptr<BookMap> newBooks = books ? std::make_shared<BookMap>(*books)
+                                                  : std::make_shared<BookMap>();
+        std::shared_ptr<ContextBook> book = std::make_shared<ContextBook>();
+        (*newBooks)[contextId] = book;
+        std::atomic_store(&shard.books, std::shared_ptr<const BookMap>(std::move(newBooks)));
+        return book;
+    }
+
+    mutable std::array<Shard, nShards> shards_;
+};
+
+} // namespace signaling
+} // namespace graybat
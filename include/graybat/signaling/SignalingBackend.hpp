@@ -0,0 +1,72 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Stl
+#include <string>
+#include <utility>
+#include <vector>
+
+// Graybat
+#include <graybat/signaling/GrpcSignalingTypes.hpp>
+
+namespace graybat {
+namespace signaling {
+
+/**
+ * @brief Interface of the rendezvous service peers of socket based
+ *        communication policies use to find each other.
+ *
+ * Lookups block until the requested peers registered.
+ */
+class SignalingBackend {
+  public:
+    virtual ~SignalingBackend() = default;
+
+    /**
+     * @brief Returns the id of the context with *contextName*, all
+     *        peers requesting the same name get the same id until
+     *        the context is left.
+     */
+    virtual ContextId requestContext(const ContextName& contextName) = 0;
+
+    /**
+     * @brief Registers the uris of a peer and returns its vaddr.
+     */
+    virtual Vaddr requestVaddr(ContextId contextId, const Uri& dataUri, const Uri& ctrlUri) = 0;
+
+    /**
+     * @brief Returns data and ctrl uri of a single peer.
+     */
+    virtual std::pair<Uri, Uri> lookupVaddr(ContextId contextId, Vaddr vaddr) = 0;
+
+    /**
+     * @brief Returns data and ctrl uris of all *contextSize* peers of
+     *        a context ordered by vaddr.
+     */
+    virtual std::vector<std::pair<Uri, Uri>>
+    lookupContext(ContextId contextId, std::size_t contextSize) = 0;
+
+    virtual void leaveContext(const ContextName& contextName) = 0;
+};
+
+} // namespace signaling
+} // namespace graybat
@@ -0,0 +1,55 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Stl
+#include <memory>
+#include <string>
+
+// Graybat
+#include <graybat/signaling/FileSignalingBackend.hpp>
+#include <graybat/signaling/GrpcSignalingBackend.hpp>
+#include <graybat/signaling/SignalingBackend.hpp>
+
+namespace graybat {
+namespace signaling {
+
+/**
+ * @brief Creates the signaling backend for *masterUri*.
+ *
+ * Uris of the form file://<directory> select the FileSignalingBackend
+ * on <directory>, all other uris are addresses of a grpc signaling
+ * server (e.g. localhost:5000).
+ */
+inline std::unique_ptr<SignalingBackend> makeSignalingBackend(const std::string& masterUri)
+{
+    const std::string fileScheme = "file://";
+
+    if (masterUri.compare(0, fileScheme.size(), fileScheme) == 0) {
+        return std::unique_ptr<SignalingBackend>(
+            new FileSignalingBackend(masterUri.substr(fileScheme.size())));
+    }
+
+    return std::unique_ptr<SignalingBackend>(new GrpcSignalingBackend(masterUri));
+}
+
+} // namespace signaling
+} // namespace graybat
@@ -0,0 +1,343 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+// STL
+#include <algorithm> /* std::max */
+#include <atomic> /* std::atomic */
+#include <cstddef> /* std::size_t, std::max_align_t */
+#include <cstdint> /* std::uint32_t */
+#include <fstream> /* std::ifstream */
+#include <memory> /* std::unique_ptr */
+#include <mutex> /* std::mutex, std::lock_guard */
+#include <new> /* ::operator new */
+#include <sstream> /* std::istringstream */
+#include <string> /* std::string, std::to_string */
+#include <vector> /* std::vector */
+
+// CLIB
+#ifdef __linux__
+#include <sched.h> /* sched_getcpu */
+#include <sys/mman.h> /* mmap, munmap */
+#endif
+
+namespace utils {
+
+/**
+ * @brief Process wide pool of byte buffers in power of two size classes.
+ *
+ * Released buffers are kept in a free list per size class and NUMA
+ * node and handed out again to threads running on that node. A buffer
+ * always returns to the free list of the node it was allocated on,
+ * which is where its pages live after the first touch. Buffers larger
+ * than the largest size class are not pooled. All free lists together
+ * cache at most maxTotalCachedBytes, buffers released above that go
+ * back to the OS. Thread safe, release() can be passed to ZMQ as free
+ * function of a message.
+ */
+class BufferPool {
+  public:
+    static constexpr std::size_t minClassSize = 64;
+    static constexpr std::size_t nClasses = 21;
+    static constexpr std::size_t maxClassSize = minClassSize << (nClasses - 1);
+
+    // Bytes cached per size class and node, at least minCached buffers
+    static constexpr std::size_t maxCachedBytes = 64 << 20;
+    static constexpr std::size_t minCached = 4;
+
+    // Bytes cached by all free lists together
+    static constexpr std::size_t maxTotalCachedBytes = 256 << 20;
+
+    // Buffers of this size and above are mapped from the OS directly,
+    // thus freeing them returns their pages no matter how the heap
+    // adapted its own mmap threshold
+    static constexpr std::size_t minMappedSize = 128 << 10;
+
+    /**
+     * @brief The pool is never destroyed, ZMQ may release buffers
+     *        from its I/O threads until the very end of the process.
+     */
+    static BufferPool& instance()
+    {
+        static BufferPool* pool = new BufferPool();
+        return *pool;
+    }
+
+    static void release(void* buffer, void* /* hint */)
+    {
+        instance().deallocate(buffer);
+    }
+
+    void* allocate(std::size_t const size)
+    {
+        const std::size_t sizeClass = classOf(size);
+        if (sizeClass == nClasses) {
+            return init(::operator new(headerSize + size), nClasses, 0);
+        }
+
+        const std::size_t node = currentNode();
+        FreeList& freeList = freeLists_[node * nClasses + sizeClass];
+        {
+            std::lock_guard<std::mutex> lock(freeList.mtx);
+            if (!freeList.buffers.empty()) {
+                void* buffer = freeList.buffers.back();
+                freeList.buffers.pop_back();
+                cachedBytes_ -= classSize(sizeClass);
+                return buffer;
+            }
+        }
+        return init(allocateMemory(headerSize + classSize(sizeClass)), sizeClass, node);
+    }
+
+    void deallocate(void* const buffer)
+    {
+        if (buffer == nullptr) {
+            return;
+        }
+
+        Header* header = headerOf(buffer);
+        if (header->sizeClass == nClasses) {
+            ::operator delete(header);
+            return;
+        }
+
+        const std::size_t size = classSize(header->sizeClass);
+        {
+            FreeList& freeList = freeLists_[header->node * nClasses + header->sizeClass];
+            std::lock_guard<std::mutex> lock(freeList.mtx);
+            if (freeList.buffers.size() < maxCached(header->sizeClass)) {
+                if (cachedBytes_.fetch_add(size) + size <= maxTotalCachedBytes) {
+                    freeList.buffers.push_back(buffer);
+                    return;
+                }
+                cachedBytes_ -= size;
+            }
+        }
+        freeMemory(header, headerSize + size);
+    }
+
+    /**
+     * @brief Returns all cached buffers to the OS.
+     */
+    void trim()
+    {
+        for (std::size_t list_i = 0; list_i < nNodes_ * nClasses; ++list_i) {
+            FreeList& freeList = freeLists_[list_i];
+            const std::size_t size = classSize(list_i % nClasses);
+            std::lock_guard<std::mutex> lock(freeList.mtx);
+            for (void* buffer : freeList.buffers) {
+                freeMemory(headerOf(buffer), headerSize + size);
+            }
+            cachedBytes_ -= freeList.buffers.size() * size;
+            freeList.buffers.clear();
+        }
+    }
+
+    /**
+     * @brief Number of buffers of the size class of *size* cached for
+     *        the node of the calling thread.
+     */
+    std::size_t cached(std::size_t const size)
+    {
+        FreeList& freeList = freeLists_[currentNode() * nClasses + classOf(size)];
+        std::lock_guard<std::mutex> lock(freeList.mtx);
+        return freeList.buffers.size();
+    }
+
+    /**
+     * @brief Bytes cached by all free lists.
+     */
+    std::size_t cachedBytes() const
+    {
+        return cachedBytes_;
+    }
+
+    static std::size_t classSize(std::size_t const sizeClass)
+    {
+        return minClassSize << sizeClass;
+    }
+
+  private:
+    struct Header {
+        std::uint32_t sizeClass;
+        std::uint32_t node;
+    };
+    static constexpr std::size_t headerSize = alignof(std::max_align_t);
+    static_assert(sizeof(Header) <= headerSize, "Buffer header does not fit.");
+
+    struct FreeList {
+        std::mutex mtx;
+        std::vector<void*> buffers;
+    };
+
+    BufferPool()
+        : cpuNodes_(readCpuNodes())
+        , nNodes_(1)
+        , cachedBytes_(0)
+    {
+        for (std::size_t node : cpuNodes_) {
+            nNodes_ = std::max(nNodes_, node + 1);
+        }
+        freeLists_.reset(new FreeList[nNodes_ * nClasses]);
+    }
+
+    static std::size_t classOf(std::size_t const size)
+    {
+        std::size_t sizeClass = 0;
+        while (sizeClass < nClasses && classSize(sizeClass) < size) {
+            ++sizeClass;
+        }
+        return sizeClass;
+    }
+
+    static std::size_t maxCached(std::size_t const sizeClass)
+    {
+        const std::size_t nBuffers = maxCachedBytes / classSize(sizeClass);
+        return nBuffers < minCached ? std::size_t(minCached) : nBuffers;
+    }
+
+    static void* allocateMemory(std::size_t const size)
+    {
+#ifdef __linux__
+        if (size >= minMappedSize) {
+            void* memory
+                = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return memory;
+        }
+#endif
+        return ::operator new(size);
+    }
+
+    static void freeMemory(void* const memory, std::size_t const size)
+    {
+#ifdef __linux__
+        if (size >= minMappedSize) {
+            ::munmap(memory, size);
+            return;
+        }
+#endif
+        ::operator delete(memory);
+    }
+
+    static Header* headerOf(void* const buffer)
+    {
+        return reinterpret_cast<Header*>(static_cast<char*>(buffer) - headerSize);
+    }
+
+    static void* init(void* const memory, std::size_t const sizeClass, std::size_t const node)
+    {
+        Header* header = static_cast<Header*>(memory);
+        header->sizeClass = static_cast<std::uint32_t>(sizeClass);
+        header->node = static_cast<std::uint32_t>(node);
+        return static_cast<char*>(memory) + headerSize;
+    }
+
+    std::size_t currentNode() const
+    {
+#ifdef __linux__
+        const int cpu = sched_getcpu();
+        if (cpu >= 0 && static_cast<std::size_t>(cpu) < cpuNodes_.size()) {
+            return cpuNodes_[cpu];
+        }
+#endif
+        return 0;
+    }
+
+    /**
+     * @brief Node of each cpu from the cpu lists (e.g. "0-3,8-11")
+     *        of the nodes in sysfs, empty without NUMA information.
+     */
+    static std::vector<std::size_t> readCpuNodes()
+    {
+        std::vector<std::size_t> cpuNodes;
+        for (std::size_t node = 0;; ++node) {
+            std::ifstream cpuList(
+                "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!cpuList) {
+                return cpuNodes;
+            }
+
+            std::string range;
+            while (std::getline(cpuList, range, ',')) {
+                std::istringstream bounds(range);
+                std::size_t first = 0;
+                std::size_t last = 0;
+                char dash = 0;
+                if (!(bounds >> first)) {
+                    continue;
+                }
+                last = (bounds >> dash >> last) ? last : first;
+                if (cpuNodes.size() <= last) {
+                    cpuNodes.resize(last + 1, 0);
+                }
+                for (std::size_t cpu = first; cpu <= last; ++cpu) {
+                    cpuNodes[cpu] = node;
+                }
+            }
+        }
+    }
+
+    const std::vector<std::size_t> cpuNodes_;
+    std::size_t nNodes_;
+    std::unique_ptr<FreeList[]> freeLists_;
+    std::atomic<std::size_t> cachedBytes_;
+};
+
+/**
+ * @brief Allocator of standard containers backed by the BufferPool.
+ */
+template <typename T> struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template <typename U> PoolAllocator(PoolAllocator<U> const&)
+    {
+    }
+
+    T* allocate(std::size_t const n)
+    {
+        return static_cast<T*>(BufferPool::instance().allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* const pointer, std::size_t)
+    {
+        BufferPool::instance().deallocate(pointer);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(PoolAllocator<T> const&, PoolAllocator<U> const&)
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(PoolAllocator<T> const&, PoolAllocator<U> const&)
+{
+    return false;
+}
+
+} /* utils */
@@ -393,32 +393,32 @@ template <typename T_Value, typename... T_Keys> struct MessageBox {
 
         {
             std::lock_guard<std::mutex> accessLock(access);
-            return multiKeyMap.at(keys...).front().size();
+            return multiKeyMap.at(keys...).front().getDataSize();
         }
     }
 
     /**
-     * @brief Estimates the size of a message with specified keys if available,otherwise return 0.
+     * @brief Estimates the size of a message with specified keys if available,otherwise return none.
      * @param keys
      * @return size of message in the inbox
      */
-    auto tryProbe(const T_Keys... keys) -> std::size_t
+    auto tryProbe(const T_Keys... keys) -> boost::optional<std::size_t>
     {
 
         {
             std::lock_guard<std::mutex> accessLock(access);
             if (!multiKeyMap.test(keys...)) {
-                return 0;
+                return boost::none;
             }
         }
 
         if (multiKeyMap.at(keys...).empty()) {
-            return 0;
+            return boost::none;
         }
 
         {
             std::lock_guard<std::mutex> accessLock(access);
-            return multiKeyMap.at(keys...).front().size();
+            return multiKeyMap.at(keys...).front().getDataSize();
         }
     }
 };
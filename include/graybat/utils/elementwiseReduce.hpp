@@ -0,0 +1,341 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstddef> /* std::size_t */
+#include <cstdint> /* std::int32_t, std::uint32_t */
+#include <functional> /* std::plus, std::multiplies */
+#include <type_traits> /* std::integral_constant */
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define GRAYBAT_SIMD_REDUCE_ENABLED
+#include <immintrin.h>
+#endif
+
+namespace utils {
+
+/**
+ * @brief Binary operator that returns the smaller of two values,
+ *        like std::plus it can be used as reduction operator.
+ */
+template <class T>
+struct minimum {
+    T operator()(const T& a, const T& b) const
+    {
+        return b < a ? b : a;
+    }
+};
+
+/**
+ * @brief Binary operator that returns the larger of two values,
+ *        like std::plus it can be used as reduction operator.
+ */
+template <class T>
+struct maximum {
+    T operator()(const T& a, const T& b) const
+    {
+        return a < b ? b : a;
+    }
+};
+
+namespace detail {
+
+enum class ReduceOp { plus, multiplies, minimum, maximum };
+
+/**
+ * @brief Value types for which vectorized kernels exist.
+ */
+template <class T>
+struct IsSimdType : std::integral_constant<
+                        bool,
+                        std::is_same<T, float>::value || std::is_same<T, double>::value
+                            || std::is_same<T, std::int32_t>::value
+                            || std::is_same<T, std::uint32_t>::value> {
+};
+
+/**
+ * @brief Maps a binary operator on T to a ReduceOp for which
+ *        vectorized kernels exist. Other operators use the
+ *        generic loop.
+ */
+template <class T_Op, class T>
+struct SimdReduceOp : std::false_type {
+};
+
+template <class T>
+struct SimdReduceOp<std::plus<T>, T> : IsSimdType<T> {
+    static constexpr ReduceOp op = ReduceOp::plus;
+};
+
+template <class T>
+struct SimdReduceOp<std::multiplies<T>, T> : IsSimdType<T> {
+    static constexpr ReduceOp op = ReduceOp::multiplies;
+};
+
+template <class T>
+struct SimdReduceOp<minimum<T>, T> : IsSimdType<T> {
+    static constexpr ReduceOp op = ReduceOp::minimum;
+};
+
+template <class T>
+struct SimdReduceOp<maximum<T>, T> : IsSimdType<T> {
+    static constexpr ReduceOp op = ReduceOp::maximum;
+};
+
+#ifdef GRAYBAT_SIMD_REDUCE_ENABLED
+
+enum class Isa { generic, avx2, avx512 };
+
+inline Isa detectIsa()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return Isa::avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::avx2;
+    }
+    return Isa::generic;
+}
+
+inline Isa supportedIsa()
+{
+    static const Isa isa = detectIsa();
+    return isa;
+}
+
+/**
+ * The kernels reduce src into dst (dst[i] = op(dst[i], src[i])) and return
+ * the number of elements processed. The remaining tail is left to the
+ * generic loop. Operand order of min and max matches minimum and maximum.
+ */
+__attribute__((target("avx2"))) inline std::size_t
+reduceAvx2(ReduceOp op, const float* src, float* dst, std::size_t n)
+{
+    const std::size_t width = 8;
+    std::size_t i = 0;
+    for (; i + width <= n; i += width) {
+        __m256 a = _mm256_loadu_ps(dst + i);
+        __m256 b = _mm256_loadu_ps(src + i);
+        switch (op) {
+        case ReduceOp::plus: a = _mm256_add_ps(a, b); break;
+        case ReduceOp::multiplies: a = _mm256_mul_ps(a, b); break;
+        case ReduceOp::minimum: a = _mm256_min_ps(b, a); break;
+        case ReduceOp::maximum: a = _mm256_max_ps(b, a); break;
+        }
+        _mm256_storeu_ps(dst + i, a);
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) inline std::size_t
+reduceAvx2(ReduceOp op, const double* src, double* dst, std::size_t n)
+{
+    const std::size_t width = 4;
+    std::size_t i = 0;
+    for (; i + width <= n; i += width) {
+        __m256d a = _mm256_loadu_pd(dst + i);
+        __m256d b = _mm256_loadu_pd(src + i);
+        switch (op) {
+        case ReduceOp::plus: a = _mm256_add_pd(a, b); break;
+        case ReduceOp::multiplies: a = _mm256_mul_pd(a, b); break;
+        case ReduceOp::minimum: a = _mm256_min_pd(b, a); break;
+        case ReduceOp::maximum: a = _mm256_max_pd(b, a); break;
+        }
+        _mm256_storeu_pd(dst + i, a);
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) inline std::size_t
+reduceAvx2(ReduceOp op, const std::int32_t* src, std::int32_t* dst, std::size_t n)
+{
+    const std::size_t width = 8;
+    std::size_t i = 0;
+    for (; i + width <= n; i += width) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        switch (op) {
+        case ReduceOp::plus: a = _mm256_add_epi32(a, b); break;
+        case ReduceOp::multiplies: a = _mm256_mullo_epi32(a, b); break;
+        case ReduceOp::minimum: a = _mm256_min_epi32(a, b); break;
+        case ReduceOp::maximum: a = _mm256_max_epi32(a, b); break;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), a);
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) inline std::size_t
+reduceAvx2(ReduceOp op, const std::uint32_t* src, std::uint32_t* dst, std::size_t n)
+{
+    const std::size_t width = 8;
+    std::size_t i = 0;
+    for (; i + width <= n; i += width) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        switch (op) {
+        case ReduceOp::plus: a = _mm256_add_epi32(a, b); break;
+        case ReduceOp::multiplies: a = _mm256_mullo_epi32(a, b); break;
+        case ReduceOp::minimum: a = _mm256_min_epu32(a, b); break;
+        case ReduceOp::maximum: a = _mm256_max_epu32(a, b); break;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), a);
+    }
+    return i;
+}
+
+// Min and max are masked with an explicit source, the unmasked
+// intrinsics pass an undefined one that gcc warns about
+constexpr __mmask16 all32BitLanes = 0xffff;
+constexpr __mmask8 all64BitLanes = 0xff;
+
+__attribute__((target("avx512f"))) inline std::size_t
+reduceAvx512(ReduceOp op, const float* src, float* dst, std::size_t n)
+{
+    const std::size_t width = 16;
+    std::size_t i = 0;
+    for (; i + width <= n; i += width) {
+        __m512 a = _mm512_loadu_ps(dst + i);
+        __m512 b = _mm512_loadu_ps(src + i);
+        switch (op) {
+        case ReduceOp::plus: a = _mm512_add_ps(a, b); break;
+        case ReduceOp::multiplies: a = _mm512_mul_ps(a, b); break;
+        case ReduceOp::minimum: a = _mm512_mask_min_ps(b, all32BitLanes, b, a); break;
+        case ReduceOp::maximum: a = _mm512_mask_max_ps(b, all32BitLanes, b, a); break;
+        }
+        _mm512_storeu_ps(dst + i, a);
+    }
+    return i;
+}
+
+__attribute__((target("avx512f"))) inline std::size_t
+reduceAvx512(ReduceOp op, const double* src, double* dst, std::size_t n)
+{
+    const std::size_t width = 8;
+    std::size_t i = 0;
+    for (; i + width <= n; i += width) {
+        __m512d a = _mm512_loadu_pd(dst + i);
+        __m512d b = _mm512_loadu_pd(src + i);
+        switch (op) {
+        case ReduceOp::plus: a = _mm512_add_pd(a, b); break;
+        case ReduceOp::multiplies: a = _mm512_mul_pd(a, b); break;
+        case ReduceOp::minimum: a = _mm512_mask_min_pd(b, all64BitLanes, b, a); break;
+        case ReduceOp::maximum: a = _mm512_mask_max_pd(b, all64BitLanes, b, a); break;
+        }
+        _mm512_storeu_pd(dst + i, a);
+    }
+    return i;
+}
+
+__attribute__((target("avx512f"))) inline std::size_t
+reduceAvx512(ReduceOp op, const std::int32_t* src, std::int32_t* dst, std::size_t n)
+{
+    const std::size_t width = 16;
+    std::size_t i = 0;
+    for (; i + width <= n; i += width) {
+        __m512i a = _mm512_loadu_si512(dst + i);
+        __m512i b = _mm512_loadu_si512(src + i);
+        switch (op) {
+        case ReduceOp::plus: a = _mm512_add_epi32(a, b); break;
+        case ReduceOp::multiplies: a = _mm512_mullo_epi32(a, b); break;
+        case ReduceOp::minimum: a = _mm512_mask_min_epi32(a, all32BitLanes, a, b); break;
+        case ReduceOp::maximum: a = _mm512_mask_max_epi32(a, all32BitLanes, a, b); break;
+        }
+        _mm512_storeu_si512(dst + i, a);
+    }
+    return i;
+}
+
+__attribute__((target("avx512f"))) inline std::size_t
+reduceAvx512(ReduceOp op, const std::uint32_t* src, std::uint32_t* dst, std::size_t n)
+{
+    const std::size_t width = 16;
+    std::size_t i = 0;
+    for (; i + width <= n; i += width) {
+        __m512i a = _mm512_loadu_si512(dst + i);
+        __m512i b = _mm512_loadu_si512(src + i);
+        switch (op) {
+        case ReduceOp::plus: a = _mm512_add_epi32(a, b); break;
+        case ReduceOp::multiplies: a = _mm512_mullo_epi32(a, b); break;
+        case ReduceOp::minimum: a = _mm512_mask_min_epu32(a, all32BitLanes, a, b); break;
+        case ReduceOp::maximum: a = _mm512_mask_max_epu32(a, all32BitLanes, a, b); break;
+        }
+        _mm512_storeu_si512(dst + i, a);
+    }
+    return i;
+}
+
+template <class T>
+std::size_t simdReduce(ReduceOp op, const T* src, T* dst, std::size_t n)
+{
+    switch (supportedIsa()) {
+    case Isa::avx512: return reduceAvx512(op, src, dst, n);
+    case Isa::avx2: return reduceAvx2(op, src, dst, n);
+    default: return 0;
+    }
+}
+
+#endif
+
+template <class T_Op, class T>
+std::size_t simdReduce(T_Op, const T* src, T* dst, std::size_t n, std::true_type)
+{
+#ifdef GRAYBAT_SIMD_REDUCE_ENABLED
+    return simdReduce(SimdReduceOp<T_Op, T>::op, src, dst, n);
+#else
+    (void)src;
+    (void)dst;
+    (void)n;
+    return 0;
+#endif
+}
+
+template <class T_Op, class T>
+std::size_t simdReduce(T_Op, const T*, T*, std::size_t, std::false_type)
+{
+    return 0;
+}
+
+} /* detail */
+
+/**
+ * @brief Reduces *n* elements of *src* elementwise into *dst*
+ *        (dst[i] = op(dst[i], src[i])).
+ *
+ * std::plus, std::multiplies, minimum and maximum on float, double
+ * and 32 bit integers use AVX2 or AVX-512 kernels, selected at runtime
+ * by the capabilities of the cpu. All other operators and the remaining
+ * elements are reduced by a loop over non-aliasing raw pointers.
+ */
+template <class T_Op, class T>
+void elementwiseReduce(T_Op op, const T* __restrict__ src, T* __restrict__ dst, std::size_t n)
+{
+    std::size_t i = detail::simdReduce(
+        op, src, dst, n, std::integral_constant<bool, detail::SimdReduceOp<T_Op, T>::value>());
+
+    for (; i < n; ++i) {
+        dst[i] = op(dst[i], src[i]);
+    }
+}
+
+} /* utils */
@@ -0,0 +1,192 @@
+/**
+ * Copyright 2016 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Counts heap allocations per message of the steady state Cage
+ * send/recv path. Allocations are counted by replacing the global
+ * operator new, thus this benchmark is a target of its own. Exits
+ * with failure when there are more allocations per message than
+ * given as first argument for BMPI (default 0) and as second
+ * argument for ZMQ (default 2).
+ *
+ * ZMQ allocates the content of each message larger than 32 bytes
+ * itself, once when sent and once when received. The ZMQ part needs
+ * a signaling server and only runs when the environment variable
+ * GRAYBAT_MASTER_URI names one.
+ */
+
+// Stl
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// Boost
+#include <boost/core/ignore_unused.hpp>
+
+// Graybat
+#include <graybat/graybat.hpp>
+
+namespace {
+std::atomic<bool> counting(false);
+std::atomic<std::size_t> nAllocations(0);
+}
+
+// Not inlined, otherwise the compiler pairs the malloc of operator
+// new with the delete expressions of the callers and warns about it
+__attribute__((noinline)) void* operator new(std::size_t size)
+{
+    if (counting) {
+        ++nAllocations;
+    }
+    void* pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+__attribute__((noinline)) void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+__attribute__((noinline)) void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+__attribute__((noinline)) void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+__attribute__((noinline)) void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+__attribute__((noinline)) void operator delete[](void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+using GP = graybat::graphPolicy::BGL<>;
+using Serialization = graybat::serializationPolicy::ByteCast;
+
+/**
+ * @return allocations per message of *nSteps* steps, in each step
+ *         every hosted vertex sends to and receives from all its
+ *         neighbors.
+ */
+template <typename T_Cage> double allocationsPerMessage(T_Cage& cage, unsigned const nSteps)
+{
+    using Event = typename T_Cage::Event;
+    using Edge = typename T_Cage::Edge;
+
+    cage.setGraph(graybat::pattern::FullyConnected<GP>(cage.getPeers().size()));
+    cage.distribute(graybat::mapping::Roundrobin());
+
+    std::vector<Edge> outEdges;
+    std::vector<Edge> inEdges;
+    for (auto& vertex : cage.getHostedVertices()) {
+        for (Edge edge : cage.getOutEdges(vertex)) {
+            outEdges.push_back(edge);
+        }
+        for (Edge edge : cage.getInEdges(vertex)) {
+            inEdges.push_back(edge);
+        }
+    }
+
+    std::vector<Event> events;
+    events.reserve(outEdges.size());
+    std::vector<unsigned> send(100, 1);
+    std::vector<unsigned> recv(100, 0);
+
+    auto step = [&]() {
+        for (Edge& edge : outEdges) {
+            cage.send(edge, send, events);
+        }
+        for (Edge& edge : inEdges) {
+            cage.recv(edge, recv);
+        }
+        for (Event& event : events) {
+            event.wait();
+        }
+        events.clear();
+    };
+
+    // Warm up pools and queues
+    for (unsigned step_i = 0; step_i < nSteps; ++step_i) {
+        step();
+    }
+
+    nAllocations = 0;
+    counting = true;
+    for (unsigned step_i = 0; step_i < nSteps; ++step_i) {
+        step();
+    }
+    counting = false;
+
+    const std::size_t nMessages = nSteps * (outEdges.size() + inEdges.size());
+    return nMessages == 0 ? 0 : static_cast<double>(nAllocations) / nMessages;
+}
+
+int main(int argc, char** argv)
+{
+    const unsigned nSteps = 1000;
+    bool success = true;
+    boost::ignore_unused(argc, argv);
+
+#ifdef graybat_BMPI_CP_ENABLED
+    const double maxBmpiAllocationsPerMessage = argc > 1 ? std::stod(argv[1]) : 0;
+    {
+        using BMPI = graybat::communicationPolicy::BMPI;
+        BMPI::Config config;
+        graybat::Cage<BMPI, GP, Serialization> cage(config);
+
+        const double perMessage = allocationsPerMessage(cage, nSteps);
+        std::cout << "BMPI: " << perMessage << " allocations per message" << std::endl;
+        success = success && perMessage <= maxBmpiAllocationsPerMessage;
+    }
+#endif
+
+#ifdef graybat_ZMQ_CP_ENABLED
+    const double maxZmqAllocationsPerMessage = argc > 2 ? std::stod(argv[2]) : 2;
+    const char* masterUri = std::getenv("GRAYBAT_MASTER_URI");
+    if (masterUri != nullptr) {
+        using ZMQ = graybat::communicationPolicy::ZMQ;
+        ZMQ::Config config;
+        config.masterUri = masterUri;
+        config.peerUri = "tcp://127.0.0.1:5001";
+        config.contextSize = std::stoi(std::getenv("OMPI_COMM_WORLD_SIZE"));
+        config.contextName = "context_allocations";
+        graybat::Cage<ZMQ, GP, Serialization> cage(config);
+
+        const double perMessage = allocationsPerMessage(cage, nSteps);
+        std::cout << "ZMQ: " << perMessage << " allocations per message" << std::endl;
+        success = success && perMessage <= maxZmqAllocationsPerMessage;
+    }
+#endif
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -24,6 +24,7 @@
 #include <functional> /* std::plus, std::ref */
 #include <iostream> /* std::cout, std::endl */
 #include <list> /* std::list */
+#include <map> /* std::map */
 #include <string> /* std::string, std::stoi */
 #include <vector>
 
@@ -43,7 +44,7 @@ namespace hana = boost::hana;
 
 namespace {
 size_t const nRuns = 1;
-auto cages = graybat::test::utils::getCages();
+auto cages = graybat::test::utils::getCages("cage");
 }
 
 BOOST_AUTO_TEST_SUITE(graybat_cage_tests)
@@ -91,6 +92,7 @@ BOOST_AUTO_TEST_CASE(send_recv)
                         cage->send(edge, send, events);
                     }
                 }
+                cage->flush();
 
                 // Recv state from neighbor cells
                 for (Vertex& v : cage->getHostedVertices()) {
@@ -373,24 +375,26 @@ BOOST_AUTO_TEST_CASE(gather)
         // Test run
         {
             cage->setGraph(graybat::pattern::Grid<GP>(3, 3));
-            cage->distribute(graybat::mapping::Consecutive());
+            cage->distribute(graybat::mapping::Roundrobin());
 
             const unsigned nElements = 10;
-            const unsigned testValue = 1;
             const bool reorder = true;
 
-            std::vector<unsigned> send(nElements, testValue);
-            std::vector<unsigned> recv(nElements * cage->getVertices().size(), 0);
-
             Vertex rootVertex = cage->getVertex(0);
 
-            for (Vertex v : cage->getHostedVertices()) {
-                cage->gather(rootVertex, v, send, recv, reorder);
-            }
+            // Gather several times to reuse the reorder plan of the distribution
+            for (unsigned run_i = 0; run_i < nRuns + 1; ++run_i) {
+                std::vector<unsigned> recv(nElements * cage->getVertices().size(), 0);
 
-            if (cage->isHosting(rootVertex)) {
-                for (unsigned receivedElement : recv) {
-                    BOOST_CHECK_EQUAL(receivedElement, testValue);
+                for (Vertex v : cage->getHostedVertices()) {
+                    std::vector<unsigned> send(nElements, v.id + run_i);
+                    cage->gather(rootVertex, v, send, recv, reorder);
+                }
+
+                if (cage->isHosting(rootVertex)) {
+                    for (unsigned i = 0; i < recv.size(); ++i) {
+                        BOOST_CHECK_EQUAL(recv[i], i / nElements + run_i);
+                    }
                 }
             }
         }
@@ -409,21 +413,113 @@ BOOST_AUTO_TEST_CASE(allGather)
         {
             cage->setGraph(
                 graybat::pattern::Grid<GP>(cage->getPeers().size(), cage->getPeers().size()));
-            cage->distribute(graybat::mapping::Consecutive());
+            cage->distribute(graybat::mapping::Roundrobin());
 
             const unsigned nElements = 10;
-            const unsigned testValue = 1;
             const bool reorder = true;
 
-            std::vector<unsigned> send(nElements, testValue);
-            std::vector<unsigned> recv(nElements * cage->getVertices().size(), 0);
+            // Gather several times to reuse the reorder plan of the distribution
+            for (unsigned run_i = 0; run_i < nRuns + 1; ++run_i) {
+                std::vector<unsigned> recv(nElements * cage->getVertices().size(), 0);
+
+                for (Vertex v : cage->getHostedVertices()) {
+                    std::vector<unsigned> send(nElements, v.id + run_i);
+                    cage->allGather(v, send, recv, reorder);
+                }
+
+                for (unsigned i = 0; i < recv.size(); ++i) {
+                    BOOST_CHECK_EQUAL(recv[i], i / nElements + run_i);
+                }
+            }
+        }
+    });
+}
+
+BOOST_AUTO_TEST_CASE(bulkReduce)
+{
+    hana::for_each(cages, [](auto cage) {
+        // Test setup
+        using Cage = typename decltype(cage)::element_type;
+        using GP = typename Cage::GraphPolicy;
+        using Vertex = typename Cage::Vertex;
+
+        // Test run
+        {
+            cage->setGraph(graybat::pattern::Grid<GP>(3, 3));
+            cage->distribute(graybat::mapping::Consecutive());
+
+            const unsigned nElements = 10;
+            const unsigned nVertices = cage->getVertices().size();
 
+            std::vector<std::pair<Vertex, std::vector<unsigned>>> contributions;
             for (Vertex v : cage->getHostedVertices()) {
-                cage->allGather(v, send, recv, reorder);
+                contributions.emplace_back(v, std::vector<unsigned>(nElements, v.id));
             }
 
-            for (unsigned receivedElement : recv) {
-                BOOST_CHECK_EQUAL(receivedElement, testValue);
+            std::vector<unsigned> recv(nElements, 0);
+            std::vector<unsigned> allRecv(nElements, 0);
+
+            Vertex rootVertex = cage->getVertex(0);
+
+            cage->reduce(rootVertex, std::plus<unsigned>(), contributions, recv);
+            cage->allReduce(std::plus<unsigned>(), contributions, allRecv);
+
+            if (cage->isHosting(rootVertex)) {
+                for (unsigned receivedElement : recv) {
+                    BOOST_CHECK_EQUAL(receivedElement, nVertices * (nVertices - 1) / 2);
+                }
+            }
+
+            if (!cage->getHostedVertices().empty()) {
+                for (unsigned receivedElement : allRecv) {
+                    BOOST_CHECK_EQUAL(receivedElement, nVertices * (nVertices - 1) / 2);
+                }
+            }
+        }
+    });
+}
+
+BOOST_AUTO_TEST_CASE(bulkGather)
+{
+    hana::for_each(cages, [](auto cage) {
+        // Test setup
+        using Cage = typename decltype(cage)::element_type;
+        using GP = typename Cage::GraphPolicy;
+        using Vertex = typename Cage::Vertex;
+
+        // Test run
+        {
+            cage->setGraph(graybat::pattern::Grid<GP>(3, 3));
+            cage->distribute(graybat::mapping::Roundrobin());
+
+            const unsigned nElements = 10;
+            const bool reorder = true;
+
+            std::vector<std::pair<Vertex, std::vector<unsigned>>> contributions;
+            for (Vertex v : cage->getHostedVertices()) {
+                contributions.emplace_back(v, std::vector<unsigned>(nElements, v.id));
+            }
+
+            std::vector<unsigned> recv;
+            std::vector<unsigned> allRecv;
+
+            Vertex rootVertex = cage->getVertex(0);
+
+            cage->gather(rootVertex, contributions, recv, reorder);
+            cage->allGather(contributions, allRecv, reorder);
+
+            if (cage->isHosting(rootVertex)) {
+                BOOST_REQUIRE_EQUAL(recv.size(), nElements * cage->getVertices().size());
+                for (unsigned i = 0; i < recv.size(); ++i) {
+                    BOOST_CHECK_EQUAL(recv[i], i / nElements);
+                }
+            }
+
+            if (!cage->getHostedVertices().empty()) {
+                BOOST_REQUIRE_EQUAL(allRecv.size(), nElements * cage->getVertices().size());
+                for (unsigned i = 0; i < allRecv.size(); ++i) {
+                    BOOST_CHECK_EQUAL(allRecv[i], i / nElements);
+                }
             }
         }
     });
@@ -469,4 +565,110 @@ BOOST_AUTO_TEST_CASE(spreadAndCollect)
     });
 }
 
+BOOST_AUTO_TEST_CASE(spreadToAllVertices)
+{
+    hana::for_each(cages, [](auto cage) {
+        // Test setup
+        using Cage = typename decltype(cage)::element_type;
+        using GP = typename Cage::GraphPolicy;
+        using Edge = typename Cage::Edge;
+        using Event = typename Cage::Event;
+        using Vertex = typename Cage::Vertex;
+
+        // Test run
+        {
+            cage->setGraph(graybat::pattern::FullyConnected<GP>(2 * cage->getPeers().size()));
+            cage->distribute(graybat::mapping::Roundrobin());
+
+            const unsigned nElements = 10;
+            std::vector<Event> events;
+
+            for (Vertex v : cage->getHostedVertices()) {
+                std::vector<unsigned> send(nElements, v.id);
+                v.spread(send, events);
+            }
+
+            for (Vertex v : cage->getHostedVertices()) {
+                for (Edge edge : cage->getInEdges(v)) {
+                    std::vector<unsigned> recv(nElements, 0);
+                    cage->recv(edge, recv);
+                    for (unsigned receivedElement : recv) {
+                        BOOST_CHECK_EQUAL(receivedElement, edge.source.id);
+                    }
+                }
+            }
+
+            for (Event& event : events) {
+                event.wait();
+            }
+        }
+    });
+}
+
+BOOST_AUTO_TEST_CASE(sparseExchange)
+{
+    hana::for_each(cages, [](auto cage) {
+        // Test setup
+        using Cage = typename decltype(cage)::element_type;
+        using GP = typename Cage::GraphPolicy;
+        using VAddr = typename Cage::VAddr;
+        using Vertex = typename Cage::Vertex;
+
+        // Test run
+        {
+            cage->setGraph(graybat::pattern::Ring<GP>(cage->getPeers().size()));
+            cage->distribute(graybat::mapping::Consecutive());
+
+            // Send the ids of hosted vertices to the hosts of their successors
+            std::map<VAddr, std::vector<unsigned>> send;
+            std::map<VAddr, std::vector<unsigned>> recv;
+
+            for (Vertex v : cage->getHostedVertices()) {
+                for (Vertex target : cage->getAdjacentVertices(v)) {
+                    send[cage->locateVertex(target)].push_back(v.id);
+                }
+            }
+
+            cage->sparseExchange(send, recv);
+
+            for (auto const& received : recv) {
+                for (unsigned vertexID : received.second) {
+                    BOOST_CHECK_EQUAL(cage->locateVertex(cage->getVertex(vertexID)), received.first);
+                }
+            }
+        }
+    });
+}
+
+BOOST_AUTO_TEST_CASE(scan)
+{
+    hana::for_each(cages, [](auto cage) {
+        // Test setup
+        using Cage = typename decltype(cage)::element_type;
+        using GP = typename Cage::GraphPolicy;
+
+        // Test run
+        {
+            const unsigned nPeers = cage->getPeers().size();
+            cage->setGraph(graybat::pattern::Ring<GP>(nPeers * 3));
+            cage->distribute(graybat::mapping::Consecutive());
+
+            // Global offsets of the hosted vertices
+            std::array<unsigned, 1> nHosted{ { (unsigned)cage->getHostedVertices().size() } };
+            std::array<unsigned, 1> offset{ { 0 } };
+            std::array<unsigned, 1> end{ { 0 } };
+
+            cage->exscan(std::plus<unsigned>(), nHosted, offset);
+            cage->scan(std::plus<unsigned>(), nHosted, end);
+
+            BOOST_CHECK_EQUAL(offset[0] + nHosted[0], end[0]);
+            for (auto v : cage->getHostedVertices()) {
+                if (v.id == nPeers * 3 - 1) {
+                    BOOST_CHECK_EQUAL(end[0], nPeers * 3);
+                }
+            }
+        }
+    });
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -25,7 +25,12 @@
 #include <boost/test/unit_test.hpp>
 
 // STL
+#include <algorithm> /* std::all_of */
+#include <array>
+#include <cstdlib>  /* std::getenv */
 #include <iostream> /* std::cout, std::endl */
+#include <numeric>  /* std::iota */
+#include <vector>
 
 // GRAYBAT
 #include <graybat/graybat.hpp>
@@ -59,6 +64,36 @@ BOOST_AUTO_TEST_CASE(context)
     });
 }
 
+BOOST_AUTO_TEST_CASE(split_context_members)
+{
+    hana::for_each(communicationPolicies, [](auto cp) {
+        auto globalContext = cp->getGlobalContext();
+        const unsigned vAddr = globalContext.getVAddr();
+        const bool isMember = vAddr % 2 == 0;
+
+        for (unsigned i = 0; i < nRuns; ++i) {
+            auto newContext = cp->splitContext(isMember, globalContext);
+
+            BOOST_REQUIRE_EQUAL(newContext.valid(), isMember);
+            if (isMember) {
+                BOOST_CHECK_EQUAL(newContext.size(), (globalContext.size() + 1) / 2);
+                BOOST_CHECK_EQUAL(newContext.getVAddr(), vAddr / 2);
+
+                // Communicate within the new context
+                const unsigned next = (newContext.getVAddr() + 1) % newContext.size();
+                const unsigned prev
+                    = (newContext.getVAddr() + newContext.size() - 1) % newContext.size();
+                std::array<unsigned, 1> send{ { newContext.getVAddr() } };
+                std::array<unsigned, 1> recv{ { 0 } };
+                auto e = cp->asyncSend(next, 0, newContext, send);
+                cp->recv(prev, 0, newContext, recv);
+                e.wait();
+                BOOST_CHECK_EQUAL(recv[0], prev);
+            }
+        }
+    });
+}
+
 BOOST_AUTO_TEST_CASE(async_send_recv)
 {
     hana::for_each(communicationPolicies, [](auto cp) {
@@ -153,7 +188,9 @@ BOOST_AUTO_TEST_CASE(send_recv_all)
         // Test run
         {
 
-            auto context = cp->getGlobalContext();
+            // Peers that are done already send the messages of the next
+            // test case, which must not be received from any source here
+            auto context = cp->splitContext(true, cp->getGlobalContext());
 
             const unsigned nElements = 10;
 
@@ -246,6 +283,46 @@ BOOST_AUTO_TEST_CASE(send_recv_order)
     });
 }
 
+BOOST_AUTO_TEST_CASE(async_multicast)
+{
+    hana::for_each(communicationPolicies, [](auto cp) {
+        // Test setup
+        using CP = typename decltype(cp)::element_type;
+        using Event = typename CP::Event;
+
+        // Test run
+        {
+
+            auto context = cp->getGlobalContext();
+
+            const unsigned nElements = 10;
+            const std::vector<unsigned> tags{ 97, 98, 99 };
+
+            std::vector<Event> events;
+            std::vector<unsigned> data(nElements, context.getVAddr());
+
+            for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+                cp->asyncMulticast(vAddr, tags, context, data, events);
+            }
+            BOOST_REQUIRE_EQUAL(events.size(), context.size() * tags.size());
+
+            for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+                for (unsigned tag : tags) {
+                    std::vector<unsigned> recv(nElements, 0);
+                    cp->recv(vAddr, tag, context, recv);
+                    for (unsigned i = 0; i < recv.size(); ++i) {
+                        BOOST_CHECK_EQUAL(recv[i], vAddr);
+                    }
+                }
+            }
+
+            for (Event& e : events) {
+                e.wait();
+            }
+        }
+    });
+}
+
 BOOST_AUTO_TEST_CASE(shouldReceiveCorrectStatus)
 {
     hana::for_each(communicationPolicies, [](auto cp) {
@@ -502,6 +579,115 @@ BOOST_AUTO_TEST_CASE(scatter)
     });
 }
 
+BOOST_AUTO_TEST_CASE(all_to_all)
+{
+    hana::for_each(communicationPolicies, [](auto cp) {
+        // Test run
+        {
+
+            auto context = cp->getGlobalContext();
+
+            const unsigned nElements = 10;
+
+            for (unsigned run_i = 0; run_i < nRuns; ++run_i) {
+
+                std::vector<unsigned> send(nElements * context.size());
+                std::vector<unsigned> recv(nElements * context.size(), 0);
+
+                for (unsigned i = 0; i < send.size(); ++i) {
+                    send[i] = context.getVAddr() * send.size() + i;
+                }
+
+                cp->allToAll(context, send, recv);
+
+                for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+                    for (unsigned i = 0; i < nElements; ++i) {
+                        BOOST_CHECK_EQUAL(
+                            recv.at(vAddr * nElements + i),
+                            vAddr * send.size() + context.getVAddr() * nElements + i);
+                    }
+                }
+            }
+        }
+
+    });
+}
+
+BOOST_AUTO_TEST_CASE(all_to_all_var)
+{
+    hana::for_each(communicationPolicies, [](auto cp) {
+        // Test setup
+        using CP = typename decltype(cp)::element_type;
+        using VAddr = typename CP::VAddr;
+
+        // Test run
+        {
+
+            auto context = cp->getGlobalContext();
+            std::vector<unsigned> recvCount;
+
+            for (unsigned run_i = 0; run_i < nRuns; ++run_i) {
+
+                // Peer sends (destination VAddr + 1) elements with its own VAddr
+                std::vector<unsigned> sendCount(context.size());
+                std::iota(sendCount.begin(), sendCount.end(), 1);
+                std::vector<unsigned> send(
+                    std::accumulate(sendCount.begin(), sendCount.end(), 0U), context.getVAddr());
+                std::vector<unsigned> recv;
+
+                cp->allToAllVar(context, send, sendCount, recv, recvCount);
+
+                BOOST_REQUIRE_EQUAL(recv.size(), context.size() * (context.getVAddr() + 1));
+                unsigned i = 0;
+                for (VAddr vAddr = 0; vAddr < context.size(); ++vAddr) {
+                    BOOST_CHECK_EQUAL(recvCount.at(vAddr), context.getVAddr() + 1);
+                    for (unsigned j = 0; j < context.getVAddr() + 1; j++) {
+                        BOOST_CHECK_EQUAL(recv.at(i), vAddr);
+                        i++;
+                    }
+                }
+            }
+        }
+
+    });
+}
+
+BOOST_AUTO_TEST_CASE(sparse_exchange)
+{
+    hana::for_each(communicationPolicies, [](auto cp) {
+        // Test setup
+        using CP = typename decltype(cp)::element_type;
+        using VAddr = typename CP::VAddr;
+
+        // Test run
+        {
+
+            auto context = cp->getGlobalContext();
+            const VAddr next = (context.getVAddr() + 1) % context.size();
+            const VAddr prev = (context.getVAddr() + context.size() - 1) % context.size();
+
+            // Exchange twice to test that consecutive exchanges do not mix up
+            for (unsigned run_i = 0; run_i < nRuns + 1; ++run_i) {
+
+                // Every peer sends (VAddr + 1) elements to its successor only
+                std::map<VAddr, std::vector<unsigned>> send;
+                std::map<VAddr, std::vector<unsigned>> recv;
+                send[next] = std::vector<unsigned>(context.getVAddr() + 1, run_i);
+
+                cp->sparseExchange(context, send, recv);
+
+                BOOST_REQUIRE_EQUAL(recv.size(), 1u);
+                BOOST_REQUIRE(recv.count(prev));
+                BOOST_CHECK_EQUAL(recv.at(prev).size(), prev + 1);
+                for (auto d : recv.at(prev)) {
+                    BOOST_CHECK_EQUAL(d, run_i);
+                }
+            }
+        }
+
+    });
+}
+
 BOOST_AUTO_TEST_CASE(reduce)
 {
     hana::for_each(communicationPolicies, [](auto cp) {
@@ -541,6 +727,64 @@ BOOST_AUTO_TEST_CASE(reduce)
     });
 }
 
+BOOST_AUTO_TEST_CASE(scan)
+{
+    hana::for_each(communicationPolicies, [](auto cp) {
+        // Test run
+        {
+
+            auto context = cp->getGlobalContext();
+            const unsigned nElements = 10;
+            const unsigned vAddr = context.getVAddr();
+
+            for (unsigned run_i = 0; run_i < nRuns; ++run_i) {
+
+                std::vector<unsigned> send(nElements, vAddr + 1);
+                std::vector<unsigned> recv(nElements, 0);
+
+                cp->scan(context, std::plus<unsigned>(), send, recv);
+
+                for (auto d : recv) {
+                    BOOST_CHECK_EQUAL(d, (vAddr + 1) * (vAddr + 2) / 2);
+                }
+            }
+        }
+
+    });
+}
+
+BOOST_AUTO_TEST_CASE(exscan)
+{
+    hana::for_each(communicationPolicies, [](auto cp) {
+        // Test run
+        {
+
+            auto context = cp->getGlobalContext();
+            const unsigned nElements = 10;
+            const unsigned vAddr = context.getVAddr();
+
+            // Associative but not commutative, result is the value of the predecessor
+            auto right = [](unsigned, unsigned b) { return b; };
+
+            for (unsigned run_i = 0; run_i < nRuns; ++run_i) {
+
+                std::vector<unsigned> send(nElements, vAddr + 1);
+                std::vector<unsigned> recvSum(nElements, 0);
+                std::vector<unsigned> recvRight(nElements, 0);
+
+                cp->exscan(context, std::plus<unsigned>(), send, recvSum);
+                cp->exscan(context, right, send, recvRight);
+
+                for (unsigned i = 0; i < nElements; ++i) {
+                    BOOST_CHECK_EQUAL(recvSum[i], vAddr * (vAddr + 1) / 2);
+                    BOOST_CHECK_EQUAL(recvRight[i], vAddr);
+                }
+            }
+        }
+
+    });
+}
+
 BOOST_AUTO_TEST_CASE(broadcast)
 {
     hana::for_each(communicationPolicies, [](auto cp) {
@@ -578,3 +822,449 @@ BOOST_AUTO_TEST_CASE(broadcast)
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+#ifdef graybat_ZMQ_CP_ENABLED
+/*******************************************************************************
+ * ZMQ Config Test Suites
+ ******************************************************************************/
+BOOST_AUTO_TEST_SUITE(graybat_cp_zmq_config)
+
+BOOST_AUTO_TEST_CASE(tree_bootstrap)
+{
+    using ZMQ = graybat::communicationPolicy::ZMQ;
+
+    const size_t rank = std::stoi(std::getenv("OMPI_COMM_WORLD_RANK"));
+
+    ZMQ::Config config = graybat::test::utils::makeZmqConfig("context_tree_bootstrap_test");
+    config.bootstrapGroupSize = 2;
+    config.bootstrapRank = rank;
+
+    ZMQ cp(config);
+    auto context = cp.getGlobalContext();
+
+    BOOST_REQUIRE_EQUAL(context.size(), config.contextSize);
+    BOOST_REQUIRE_EQUAL(context.getVAddr(), rank);
+
+    // Communicate over the bootstrapped phone book
+    const unsigned next = (context.getVAddr() + 1) % context.size();
+    const unsigned prev = (context.getVAddr() + context.size() - 1) % context.size();
+    std::array<unsigned, 1> send{ { context.getVAddr() } };
+    std::array<unsigned, 1> recv{ { 0 } };
+    auto e = cp.asyncSend(next, 0, context, send);
+    cp.recv(prev, 0, context, recv);
+    e.wait();
+    BOOST_CHECK_EQUAL(recv[0], prev);
+}
+
+BOOST_AUTO_TEST_CASE(recv_workers)
+{
+    using ZMQ = graybat::communicationPolicy::ZMQ;
+    using Event = ZMQ::Event;
+
+    ZMQ::Config config = graybat::test::utils::makeZmqConfig("context_recv_workers_test");
+    config.ioThreads = 2;
+    config.nRecvWorkers = 3;
+
+    ZMQ cp(config);
+    auto context = cp.getGlobalContext();
+    const unsigned nMessages = 100;
+    const unsigned tag = 99;
+
+    std::vector<Event> events;
+    for (unsigned msg_i = 0; msg_i < nMessages; ++msg_i) {
+        std::array<unsigned, 1> send{ { msg_i } };
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            events.push_back(cp.asyncSend(vAddr, tag, context, send));
+        }
+    }
+
+    // Messages of a source keep their order
+    for (unsigned msg_i = 0; msg_i < nMessages; ++msg_i) {
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            std::array<unsigned, 1> recv{ { 0 } };
+            cp.recv(vAddr, tag, context, recv);
+            BOOST_CHECK_EQUAL(recv[0], msg_i);
+        }
+    }
+
+    for (auto& event : events) {
+        event.wait();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batching)
+{
+    using ZMQ = graybat::communicationPolicy::ZMQ;
+    using Event = ZMQ::Event;
+
+    ZMQ::Config config = graybat::test::utils::makeZmqConfig("context_batching_test");
+    config.batchSize = 256;
+
+    ZMQ cp(config);
+    auto context = cp.getGlobalContext();
+    const unsigned nMessages = 100;
+    const unsigned tag = 99;
+
+    // Small messages are batched, large ones are sent on their own
+    std::vector<Event> events;
+    for (unsigned msg_i = 0; msg_i < nMessages; ++msg_i) {
+        std::vector<unsigned> send(msg_i % 10 == 0 ? 100 : 1, msg_i);
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            events.push_back(cp.asyncSend(vAddr, tag, context, send));
+        }
+    }
+    cp.flush();
+
+    for (unsigned msg_i = 0; msg_i < nMessages; ++msg_i) {
+        std::vector<unsigned> recv(msg_i % 10 == 0 ? 100 : 1, 0);
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            cp.recv(vAddr, tag, context, recv);
+            BOOST_CHECK_EQUAL(recv.back(), msg_i);
+        }
+    }
+
+    for (auto& event : events) {
+        event.wait();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rendezvous)
+{
+    using ZMQ = graybat::communicationPolicy::ZMQ;
+    using Event = ZMQ::Event;
+
+    ZMQ::Config config = graybat::test::utils::makeZmqConfig("context_rendezvous_test");
+    config.rendezvousThreshold = 1024;
+
+    ZMQ cp(config);
+    auto context = cp.getGlobalContext();
+    const unsigned nMessages = 20;
+    const unsigned tag = 99;
+
+    // Large messages go through the rendezvous, small ones are eager
+    std::vector<Event> events;
+    for (unsigned msg_i = 0; msg_i < nMessages; ++msg_i) {
+        std::vector<unsigned> send(msg_i % 2 == 0 ? 10000 : 1, msg_i);
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            events.push_back(cp.asyncSend(vAddr, tag, context, send));
+        }
+    }
+
+    for (unsigned msg_i = 0; msg_i < nMessages; ++msg_i) {
+        std::vector<unsigned> recv(msg_i % 2 == 0 ? 10000 : 1, 0);
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            auto status = cp.probe(vAddr, tag, context);
+            BOOST_CHECK_EQUAL(status.size<unsigned>(), recv.size());
+            cp.recv(vAddr, tag, context, recv);
+            BOOST_CHECK_EQUAL(recv.front(), msg_i);
+            BOOST_CHECK_EQUAL(recv.back(), msg_i);
+        }
+    }
+
+    for (auto& event : events) {
+        event.wait();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(chunking)
+{
+    using ZMQ = graybat::communicationPolicy::ZMQ;
+    using Event = ZMQ::Event;
+
+    ZMQ::Config config = graybat::test::utils::makeZmqConfig("context_chunking_test");
+    config.chunkSize = 4096;
+
+    ZMQ cp(config);
+    auto context = cp.getGlobalContext();
+    const unsigned nMessages = 10;
+    const unsigned nElements = 100000;
+
+    // All messages wait for their rendezvous, which happens in reverse order
+    std::vector<Event> events;
+    for (unsigned tag = 0; tag < nMessages; ++tag) {
+        std::vector<unsigned> send(nElements, tag);
+        send.back() = tag + 1;
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            events.push_back(cp.asyncSend(vAddr, tag, context, send));
+        }
+    }
+
+    for (unsigned tag = nMessages; tag-- > 0;) {
+        std::vector<unsigned> recv(nElements, 0);
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            cp.recv(vAddr, tag, context, recv);
+            BOOST_CHECK_EQUAL(recv.front(), tag);
+            BOOST_CHECK_EQUAL(recv[nElements / 2], tag);
+            BOOST_CHECK_EQUAL(recv.back(), tag + 1);
+        }
+    }
+
+    for (auto& event : events) {
+        event.wait();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(multi_rail)
+{
+    using ZMQ = graybat::communicationPolicy::ZMQ;
+
+    ZMQ::Config config = graybat::test::utils::makeZmqConfig("context_multi_rail_test");
+    config.rendezvousThreshold = 1024;
+    config.nRails = 3;
+
+    ZMQ cp(config);
+    auto context = cp.getGlobalContext();
+    const unsigned tag = 99;
+
+    // Payload is striped over the rails, one segment per rail
+    std::vector<unsigned> send(100000);
+    std::iota(send.begin(), send.end(), context.getVAddr());
+    const unsigned next = (context.getVAddr() + 1) % context.size();
+    const unsigned prev = (context.getVAddr() + context.size() - 1) % context.size();
+    auto e = cp.asyncSend(next, tag, context, send);
+
+    std::vector<unsigned> recv(send.size(), 0);
+    cp.recv(prev, tag, context, recv);
+    e.wait();
+
+    for (unsigned i = 0; i < recv.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(recv[i], prev + i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(publish_broadcasts)
+{
+    using ZMQ = graybat::communicationPolicy::ZMQ;
+
+    ZMQ::Config config = graybat::test::utils::makeZmqConfig("context_publish_broadcasts_test");
+    config.publishBroadcasts = true;
+
+    ZMQ cp(config);
+    auto context = cp.getGlobalContext();
+    const unsigned nElements = 10;
+
+    // Every peer publishes once, messages of a root keep their order
+    for (unsigned run_i = 0; run_i < 2; ++run_i) {
+        for (unsigned rootVAddr = 0; rootVAddr < context.size(); ++rootVAddr) {
+            std::vector<unsigned> data(nElements, context.getVAddr() + run_i);
+            cp.broadcast(rootVAddr, context, data);
+
+            for (auto d : data) {
+                BOOST_CHECK_EQUAL(d, rootVAddr + run_i);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
+
+#ifdef graybat_TCP_CP_ENABLED
+/*******************************************************************************
+ * TCP Test Suites
+ ******************************************************************************/
+BOOST_AUTO_TEST_SUITE(graybat_cp_tcp)
+
+BOOST_AUTO_TEST_CASE(send_recv_frames)
+{
+    using TCP = graybat::communicationPolicy::TCP;
+    using Event = TCP::Event;
+
+    TCP::Config config = graybat::test::utils::makeTcpConfig("context_tcp_send_recv_frames_test");
+
+    TCP cp(config);
+    auto context = cp.getGlobalContext();
+
+    // Frames smaller and larger than the staging buffer of a stream
+    std::vector<Event> events;
+    for (unsigned run_i = 0; run_i < 40; ++run_i) {
+        std::vector<unsigned> send(run_i * 1000 + 1, context.getVAddr() + run_i);
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            events.push_back(cp.asyncSend(vAddr, run_i, context, send));
+        }
+
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            std::vector<unsigned> recv(send.size(), 0);
+            cp.recv(vAddr, run_i, context, recv);
+            for (auto r : recv) {
+                BOOST_REQUIRE_EQUAL(r, vAddr + run_i);
+            }
+        }
+    }
+
+    for (auto& e : events) {
+        e.wait();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(io_uring_flush)
+{
+    using TCP = graybat::communicationPolicy::TCP;
+    using Event = TCP::Event;
+
+    TCP::Config config = graybat::test::utils::makeTcpConfig("context_tcp_io_uring_flush_test");
+    config.ioUring = true;
+    config.batchSize = 64 * 1024;
+
+    TCP cp(config);
+    auto context = cp.getGlobalContext();
+
+    // The batches to all peers are sent by the flush
+    std::vector<Event> events;
+    for (unsigned run_i = 0; run_i < 20; ++run_i) {
+        std::vector<unsigned> send((run_i % 5) * 3000 + 1, context.getVAddr() + run_i);
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            events.push_back(cp.asyncSend(vAddr, run_i, context, send));
+        }
+        cp.flush();
+
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            std::vector<unsigned> recv(send.size(), 0);
+            cp.recv(vAddr, run_i, context, recv);
+            for (auto r : recv) {
+                BOOST_REQUIRE_EQUAL(r, vAddr + run_i);
+            }
+        }
+    }
+
+    for (auto& e : events) {
+        e.wait();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(io_uring_batch_timeout)
+{
+    using TCP = graybat::communicationPolicy::TCP;
+    using Event = TCP::Event;
+
+    TCP::Config config = graybat::test::utils::makeTcpConfig("context_tcp_io_uring_timeout_test");
+    config.ioUring = true;
+    config.batchSize = 64 * 1024;
+
+    TCP cp(config);
+    auto context = cp.getGlobalContext();
+
+    // Without a flush the batches are sent by the batch timeout
+    std::vector<Event> events;
+    for (unsigned run_i = 0; run_i < 20; ++run_i) {
+        std::vector<unsigned> send(run_i + 1, context.getVAddr() + run_i);
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            events.push_back(cp.asyncSend(vAddr, run_i, context, send));
+        }
+
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            std::vector<unsigned> recv(send.size(), 0);
+            cp.recv(vAddr, run_i, context, recv);
+            for (auto r : recv) {
+                BOOST_REQUIRE_EQUAL(r, vAddr + run_i);
+            }
+        }
+    }
+
+    for (auto& e : events) {
+        e.wait();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(large_sends_before_recv)
+{
+    using TCP = graybat::communicationPolicy::TCP;
+    using Event = TCP::Event;
+
+    const std::size_t nMessages = 4;
+    const std::size_t messageSize = 32 * 1024 * 1024;
+
+    for (bool ioUring : { false, true }) {
+        TCP::Config config = graybat::test::utils::makeTcpConfig(
+            ioUring ? "context_tcp_large_sends_io_uring_test" : "context_tcp_large_sends_test");
+        config.ioUring = ioUring;
+        // All messages fit into the inBox, thus the peers only wait for
+        // each other by their sends
+        config.maxBufferSize = 2 * nMessages * messageSize;
+
+        TCP cp(config);
+        auto context = cp.getGlobalContext();
+        const unsigned next = (context.getVAddr() + 1) % context.size();
+        const unsigned prev = (context.getVAddr() + context.size() - 1) % context.size();
+
+        // Every peer blocks in sends to its successor, while its
+        // predecessor blocks in sends to it. The confirms of the
+        // received messages must get through anyway.
+        std::vector<std::int8_t> send(messageSize, static_cast<std::int8_t>(context.getVAddr()));
+        std::vector<Event> events;
+        for (std::size_t message_i = 0; message_i < nMessages; ++message_i) {
+            events.push_back(cp.asyncSend(next, message_i, context, send));
+        }
+
+        for (std::size_t message_i = 0; message_i < nMessages; ++message_i) {
+            std::vector<std::int8_t> recv(messageSize, -1);
+            cp.recv(prev, message_i, context, recv);
+            BOOST_REQUIRE(std::all_of(recv.begin(), recv.end(), [prev](std::int8_t r) {
+                return r == static_cast<std::int8_t>(prev);
+            }));
+        }
+
+        for (auto& e : events) {
+            e.wait();
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
+
+#ifdef graybat_BMPI_CP_ENABLED
+/*******************************************************************************
+ * BMPI Test Suites
+ ******************************************************************************/
+BOOST_AUTO_TEST_SUITE(graybat_cp_bmpi)
+
+BOOST_AUTO_TEST_CASE(copied_events)
+{
+    using BMPI = graybat::communicationPolicy::BMPI;
+    using Event = BMPI::Event;
+
+    BMPI::Config config;
+    BMPI cp(config);
+    auto context = cp.getGlobalContext();
+    const unsigned nElements = 10;
+    const unsigned tag = 99;
+
+    // Copies of an event share its request, thus each of them
+    // can be waited for after another copy completed it
+    for (unsigned i = 0; i < nRuns; ++i) {
+        std::vector<unsigned> data(nElements, 0);
+        std::iota(data.begin(), data.end(), context.getVAddr());
+        std::vector<Event> events;
+        std::vector<Event> copies;
+
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            Event e = cp.asyncSend(vAddr, tag, context, data);
+            events.push_back(e);
+            copies.push_back(e);
+        }
+
+        for (unsigned vAddr = 0; vAddr < context.size(); ++vAddr) {
+            std::vector<unsigned> recv(nElements, 0);
+            Event e = cp.asyncRecv(vAddr, tag, context, recv);
+            Event copy = e;
+            copy.wait();
+            BOOST_CHECK(e.ready());
+            e.wait();
+            for (unsigned i = 0; i < recv.size(); ++i) {
+                BOOST_CHECK_EQUAL(recv[i], vAddr + i);
+            }
+        }
+
+        for (Event& e : copies) {
+            e.wait();
+        }
+        for (Event& e : events) {
+            BOOST_CHECK(e.ready());
+            e.wait();
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
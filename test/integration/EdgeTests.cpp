@@ -40,7 +40,7 @@
 namespace hana = boost::hana;
 
 namespace {
-auto cages = graybat::test::utils::getCages();
+auto cages = graybat::test::utils::getCages("edge");
 }
 
 BOOST_AUTO_TEST_SUITE(edge)
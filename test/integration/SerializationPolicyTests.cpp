@@ -43,7 +43,7 @@ namespace hana = boost::hana;
 
 namespace {
 size_t const nRuns = 1;
-auto cages = graybat::test::utils::getCages();
+auto cages = graybat::test::utils::getCages("serialization_policy");
 }
 
 BOOST_AUTO_TEST_SUITE(graybat_serialization_policy_tests)
@@ -37,7 +37,7 @@
 namespace hana = boost::hana;
 
 namespace {
-auto cages = graybat::test::utils::getCages();
+auto cages = graybat::test::utils::getCages("vertex");
 }
 
 BOOST_AUTO_TEST_SUITE(VertexTests)
@@ -150,6 +150,23 @@ BOOST_AUTO_TEST_CASE(shouldReplyWithEmpyUriRpelyWhenVaddrNotExists)
 
 }
 
+BOOST_AUTO_TEST_CASE(shouldLookupContext)
+{
+    initContext();
+
+    ContextLookup request;
+    ContextUriReply reply;
+
+    request.set_context_id(0);
+    request.set_context_size(1);
+
+    signalingClient_.LookupContext(request, &reply);
+
+    BOOST_REQUIRE_EQUAL(reply.data_uris_size(), 1);
+    BOOST_REQUIRE_EQUAL(reply.data_uris(0), "localhost:5001");
+    BOOST_REQUIRE_EQUAL(reply.ctrl_uris(0), "localhost:5002");
+}
+
 BOOST_AUTO_TEST_CASE(shouldLeaveContext)
 {
     initContext();
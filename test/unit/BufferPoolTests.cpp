@@ -0,0 +1,130 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Stl
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Boost
+#include <boost/test/unit_test.hpp>
+
+// Graybat
+#include <graybat/utils/BufferPool.hpp>
+
+/*******************************************************************************
+ * Buffer Pool Tests
+ *******************************************************************************/
+BOOST_AUTO_TEST_SUITE(buffer_pool)
+
+BOOST_AUTO_TEST_CASE(shouldRecycleBuffersOfSameSizeClass)
+{
+    utils::BufferPool& pool = utils::BufferPool::instance();
+
+    void* buffer = pool.allocate(1000);
+    std::memset(buffer, 1, 1000);
+    pool.deallocate(buffer);
+
+    // Same size class, same node
+    void* recycled = pool.allocate(1024);
+    BOOST_CHECK(recycled == buffer);
+    pool.deallocate(recycled);
+}
+
+BOOST_AUTO_TEST_CASE(shouldNotMixSizeClasses)
+{
+    utils::BufferPool& pool = utils::BufferPool::instance();
+
+    void* small = pool.allocate(100);
+    pool.deallocate(small);
+
+    void* large = pool.allocate(100000);
+    BOOST_CHECK(large != small);
+    std::memset(large, 1, 100000);
+    pool.deallocate(large);
+}
+
+BOOST_AUTO_TEST_CASE(shouldNotPoolHugeBuffers)
+{
+    utils::BufferPool& pool = utils::BufferPool::instance();
+    const std::size_t size = utils::BufferPool::maxClassSize + 1;
+
+    const std::size_t before = pool.cached(utils::BufferPool::maxClassSize);
+    pool.deallocate(pool.allocate(size));
+    BOOST_CHECK_EQUAL(pool.cached(utils::BufferPool::maxClassSize), before);
+}
+
+BOOST_AUTO_TEST_CASE(shouldCapTotalCachedBytes)
+{
+    utils::BufferPool& pool = utils::BufferPool::instance();
+    const std::size_t largest = utils::BufferPool::maxClassSize;
+    const std::size_t maxTotalCachedBytes = utils::BufferPool::maxTotalCachedBytes;
+
+    // Both size classes alone stay within their own budget
+    std::vector<void*> buffers;
+    for (unsigned i = 0; i < utils::BufferPool::minCached; ++i) {
+        buffers.push_back(pool.allocate(largest));
+        buffers.push_back(pool.allocate(largest / 2));
+    }
+    for (void* buffer : buffers) {
+        pool.deallocate(buffer);
+    }
+    BOOST_CHECK_LE(pool.cachedBytes(), maxTotalCachedBytes);
+    BOOST_CHECK_LT(
+        pool.cached(largest) + pool.cached(largest / 2), 2 * utils::BufferPool::minCached);
+
+    pool.trim();
+    BOOST_CHECK_EQUAL(pool.cachedBytes(), 0);
+    BOOST_CHECK_EQUAL(pool.cached(largest), 0);
+}
+
+BOOST_AUTO_TEST_CASE(shouldBackStandardContainers)
+{
+    std::vector<int, utils::PoolAllocator<int>> values;
+    for (int i = 0; i < 10000; ++i) {
+        values.push_back(i);
+    }
+    BOOST_CHECK_EQUAL(values.back(), 9999);
+}
+
+BOOST_AUTO_TEST_CASE(shouldAllocateConcurrently)
+{
+    const unsigned nThreads = 8;
+    std::vector<std::thread> threads;
+
+    for (unsigned thread_i = 0; thread_i < nThreads; ++thread_i) {
+        threads.emplace_back([thread_i]() {
+            utils::BufferPool& pool = utils::BufferPool::instance();
+            for (unsigned i = 0; i < 10000; ++i) {
+                const std::size_t size = 64u << ((thread_i + i) % 8);
+                void* buffer = pool.allocate(size);
+                std::memset(buffer, static_cast<int>(thread_i), size);
+                pool.deallocate(buffer);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,163 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Stl
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Boost
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/tuple.hpp>
+#include <boost/test/unit_test.hpp>
+
+// Graybat
+#include <graybat/utils/elementwiseReduce.hpp>
+
+namespace hana = boost::hana;
+
+/*******************************************************************************
+ * Elementwise Reduce Tests
+ *******************************************************************************/
+namespace {
+
+// Not a multiple of any vector width, to cover the remaining tail
+const std::size_t nElements = 67;
+
+template <class T, class T_Op> void checkElementwiseReduce(T_Op op)
+{
+    std::vector<T> src(nElements);
+    std::vector<T> dst(nElements);
+    std::vector<T> expected(nElements);
+
+    for (std::size_t i = 0; i < nElements; ++i) {
+        src[i] = static_cast<T>((i * 7) % 13) + 1;
+        dst[i] = static_cast<T>((i * 5) % 11) + 1;
+        expected[i] = op(dst[i], src[i]);
+    }
+
+    utils::elementwiseReduce(op, src.data(), dst.data(), nElements);
+
+    for (std::size_t i = 0; i < nElements; ++i) {
+        BOOST_CHECK_EQUAL(dst[i], expected[i]);
+    }
+}
+
+auto valueTypes = hana::make_tuple(
+    hana::type_c<float>,
+    hana::type_c<double>,
+    hana::type_c<std::int32_t>,
+    hana::type_c<std::uint32_t>,
+    hana::type_c<std::int64_t>);
+}
+
+BOOST_AUTO_TEST_SUITE(elementwise_reduce)
+
+BOOST_AUTO_TEST_CASE(shouldReduceWithPlus)
+{
+    hana::for_each(valueTypes, [](auto t) {
+        using T = typename decltype(t)::type;
+        checkElementwiseReduce<T>(std::plus<T>());
+    });
+}
+
+BOOST_AUTO_TEST_CASE(shouldReduceWithMultiplies)
+{
+    hana::for_each(valueTypes, [](auto t) {
+        using T = typename decltype(t)::type;
+        checkElementwiseReduce<T>(std::multiplies<T>());
+    });
+}
+
+BOOST_AUTO_TEST_CASE(shouldReduceWithMinimum)
+{
+    hana::for_each(valueTypes, [](auto t) {
+        using T = typename decltype(t)::type;
+        checkElementwiseReduce<T>(utils::minimum<T>());
+    });
+}
+
+BOOST_AUTO_TEST_CASE(shouldReduceWithMaximum)
+{
+    hana::for_each(valueTypes, [](auto t) {
+        using T = typename decltype(t)::type;
+        checkElementwiseReduce<T>(utils::maximum<T>());
+    });
+}
+
+BOOST_AUTO_TEST_CASE(shouldReduceWithGenericOperator)
+{
+    hana::for_each(valueTypes, [](auto t) {
+        using T = typename decltype(t)::type;
+        checkElementwiseReduce<T>(std::minus<T>());
+    });
+}
+
+#ifdef GRAYBAT_SIMD_REDUCE_ENABLED
+BOOST_AUTO_TEST_CASE(shouldReduceWithAvx2Kernels)
+{
+    // The dispatch prefers AVX-512, so check the AVX2 kernels explicitly
+    if (!__builtin_cpu_supports("avx2")) {
+        return;
+    }
+
+    auto simdTypes = hana::make_tuple(
+        hana::type_c<float>,
+        hana::type_c<double>,
+        hana::type_c<std::int32_t>,
+        hana::type_c<std::uint32_t>);
+
+    hana::for_each(simdTypes, [](auto t) {
+        using T = typename decltype(t)::type;
+        using utils::detail::ReduceOp;
+
+        auto scalar = [](ReduceOp op, T a, T b) {
+            switch (op) {
+            case ReduceOp::plus: return std::plus<T>()(a, b);
+            case ReduceOp::multiplies: return std::multiplies<T>()(a, b);
+            case ReduceOp::minimum: return utils::minimum<T>()(a, b);
+            default: return utils::maximum<T>()(a, b);
+            }
+        };
+
+        for (ReduceOp op :
+             { ReduceOp::plus, ReduceOp::multiplies, ReduceOp::minimum, ReduceOp::maximum }) {
+            std::vector<T> src(nElements);
+            std::vector<T> dst(nElements);
+            std::vector<T> expected(nElements);
+
+            for (std::size_t i = 0; i < nElements; ++i) {
+                src[i] = static_cast<T>((i * 7) % 13) + 1;
+                dst[i] = static_cast<T>((i * 5) % 11) + 1;
+                expected[i] = scalar(op, dst[i], src[i]);
+            }
+
+            std::size_t n = utils::detail::reduceAvx2(op, src.data(), dst.data(), nElements);
+
+            BOOST_CHECK_EQUAL(n, nElements - nElements % (32 / sizeof(T)));
+            for (std::size_t i = 0; i < n; ++i) {
+                BOOST_CHECK_EQUAL(dst[i], expected[i]);
+            }
+        }
+    });
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
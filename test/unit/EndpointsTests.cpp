@@ -0,0 +1,79 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Boost
+#include <boost/test/unit_test.hpp>
+
+// Graybat
+#include <graybat/communicationPolicy/zmq/Endpoints.hpp>
+
+/*******************************************************************************
+ * ZMQ Endpoints Tests
+ *******************************************************************************/
+struct EndpointsTests {
+
+    EndpointsTests()
+    {
+        remote_.tcp = "tcp://127.0.0.1:5001";
+        remote_.hostId = "host";
+        remote_.ipc = "ipc:///tmp/graybat-1-0";
+        remote_.processId = "1-0x1";
+        remote_.inproc = "inproc://graybat-1-0";
+    }
+
+    graybat::communicationPolicy::zmq::Endpoints remote_;
+};
+
+BOOST_FIXTURE_TEST_SUITE(zmq_endpoints, EndpointsTests)
+
+BOOST_AUTO_TEST_CASE(shouldDecodeEncodedEndpoints)
+{
+    auto decoded = graybat::communicationPolicy::zmq::Endpoints::decode(remote_.encode());
+
+    BOOST_REQUIRE_EQUAL(decoded.tcp, remote_.tcp);
+    BOOST_REQUIRE_EQUAL(decoded.hostId, remote_.hostId);
+    BOOST_REQUIRE_EQUAL(decoded.ipc, remote_.ipc);
+    BOOST_REQUIRE_EQUAL(decoded.processId, remote_.processId);
+    BOOST_REQUIRE_EQUAL(decoded.inproc, remote_.inproc);
+}
+
+BOOST_AUTO_TEST_CASE(shouldDecodePlainUri)
+{
+    auto decoded = graybat::communicationPolicy::zmq::Endpoints::decode("tcp://127.0.0.1:5001");
+
+    BOOST_REQUIRE_EQUAL(decoded.tcp, "tcp://127.0.0.1:5001");
+    BOOST_REQUIRE_EQUAL(decoded.select(remote_), "tcp://127.0.0.1:5001");
+}
+
+BOOST_AUTO_TEST_CASE(shouldSelectCheapestEndpoint)
+{
+    graybat::communicationPolicy::zmq::Endpoints local;
+
+    local.hostId = "other host";
+    BOOST_REQUIRE_EQUAL(remote_.select(local), remote_.tcp);
+
+    local.hostId = remote_.hostId;
+    BOOST_REQUIRE_EQUAL(remote_.select(local), remote_.ipc);
+
+    local.processId = remote_.processId;
+    BOOST_REQUIRE_EQUAL(remote_.select(local), remote_.inproc);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
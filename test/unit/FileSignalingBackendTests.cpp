@@ -0,0 +1,161 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Clib
+#include <dirent.h> /* opendir */
+#include <stdlib.h> /* mkdtemp */
+
+// Stl
+#include <cstdlib> /* std::system */
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Boost
+#include <boost/test/unit_test.hpp>
+
+// Graybat
+#include <graybat/signaling/FileSignalingBackend.hpp>
+
+/*******************************************************************************
+ * File Signaling Backend Tests
+ *******************************************************************************/
+struct FileSignalingBackendTests {
+
+    FileSignalingBackendTests()
+        : directory_(makeTmpDirectory())
+        , signaling_(directory_ + "/signaling")
+    {
+    }
+
+    ~FileSignalingBackendTests()
+    {
+        std::string command = "rm -rf " + directory_;
+        if (std::system(command.c_str()) != 0) {
+            BOOST_TEST_MESSAGE("Could not remove " + directory_);
+        }
+    }
+
+    static std::string makeTmpDirectory()
+    {
+        char pattern[] = "/tmp/graybat_signaling_XXXXXX";
+        return ::mkdtemp(pattern);
+    }
+
+    // Number of records in the signaling directory
+    std::size_t countEntries() const
+    {
+        std::size_t nEntries = 0;
+        DIR* directory = ::opendir((directory_ + "/signaling").c_str());
+        while (dirent* entry = ::readdir(directory)) {
+            nEntries += entry->d_name[0] != '.';
+        }
+        ::closedir(directory);
+        return nEntries;
+    }
+
+    std::string directory_;
+    graybat::signaling::FileSignalingBackend signaling_;
+};
+
+BOOST_FIXTURE_TEST_SUITE(file_signaling_backend, FileSignalingBackendTests)
+
+BOOST_AUTO_TEST_CASE(shouldRequestContext)
+{
+    const ContextId contextId = signaling_.requestContext("context");
+
+    BOOST_REQUIRE_EQUAL(signaling_.requestContext("context"), contextId);
+    BOOST_REQUIRE_NE(signaling_.requestContext("context/leaders"), contextId);
+}
+
+BOOST_AUTO_TEST_CASE(shouldRequestNewContextAfterLeave)
+{
+    // The id stays claimed until the other peer left as well
+    graybat::signaling::FileSignalingBackend other(directory_ + "/signaling");
+    const ContextId contextId = signaling_.requestContext("context");
+    BOOST_REQUIRE_EQUAL(other.requestContext("context"), contextId);
+    signaling_.leaveContext("context");
+
+    BOOST_REQUIRE_NE(signaling_.requestContext("context"), contextId);
+}
+
+BOOST_AUTO_TEST_CASE(shouldRemoveContextWhenLastPeerLeft)
+{
+    graybat::signaling::FileSignalingBackend other(directory_ + "/signaling");
+    const ContextId contextId = signaling_.requestContext("context");
+    other.requestContext("context");
+    signaling_.requestVaddr(contextId, "data0", "ctrl0");
+    other.requestVaddr(contextId, "data1", "ctrl1");
+
+    signaling_.leaveContext("context");
+    BOOST_REQUIRE_EQUAL(countEntries(), 2);
+
+    other.leaveContext("context");
+    BOOST_REQUIRE_EQUAL(countEntries(), 0);
+
+    // The next job starts with fresh vaddrs
+    const ContextId nextContextId = signaling_.requestContext("context");
+    BOOST_REQUIRE_EQUAL(signaling_.requestVaddr(nextContextId, "data", "ctrl"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(shouldLookupVaddr)
+{
+    const ContextId contextId = signaling_.requestContext("context");
+
+    BOOST_REQUIRE_EQUAL(signaling_.requestVaddr(contextId, "localhost:5001", "localhost:5002"), 0);
+
+    auto uris = signaling_.lookupVaddr(contextId, 0);
+    BOOST_REQUIRE_EQUAL(uris.first, "localhost:5001");
+    BOOST_REQUIRE_EQUAL(uris.second, "localhost:5002");
+}
+
+BOOST_AUTO_TEST_CASE(shouldRegisterConcurrently)
+{
+    const unsigned nPeers = 16;
+    std::vector<std::thread> peers;
+    std::vector<ContextId> contextIds(nPeers);
+    std::vector<Vaddr> vaddrs(nPeers);
+
+    for (unsigned peer = 0; peer < nPeers; ++peer) {
+        peers.emplace_back([this, peer, &contextIds, &vaddrs]() {
+            // Every peer uses its own backend like separate processes
+            graybat::signaling::FileSignalingBackend signaling(directory_ + "/signaling");
+            contextIds[peer] = signaling.requestContext("context");
+            vaddrs[peer] = signaling.requestVaddr(
+                contextIds[peer], "data" + std::to_string(peer), "ctrl" + std::to_string(peer));
+        });
+    }
+
+    for (auto& peer : peers) {
+        peer.join();
+    }
+
+    BOOST_REQUIRE_EQUAL(std::set<ContextId>(contextIds.begin(), contextIds.end()).size(), 1);
+    BOOST_REQUIRE_EQUAL(std::set<Vaddr>(vaddrs.begin(), vaddrs.end()).size(), nPeers);
+
+    auto uris = signaling_.lookupContext(contextIds[0], nPeers);
+    for (unsigned peer = 0; peer < nPeers; ++peer) {
+        BOOST_REQUIRE_EQUAL(uris.at(vaddrs[peer]).first, "data" + std::to_string(peer));
+        BOOST_REQUIRE_EQUAL(uris.at(vaddrs[peer]).second, "ctrl" + std::to_string(peer));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,56 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Stl
+#include <stdexcept>
+#include <utility>
+
+// Boost
+#include <boost/test/unit_test.hpp>
+
+// Graybat
+#include <graybat/communicationPolicy/tcp/Frame.hpp>
+
+using graybat::communicationPolicy::tcp::Frame;
+
+/*******************************************************************************
+ * Frame Tests
+ *******************************************************************************/
+BOOST_AUTO_TEST_SUITE(tcp_frame)
+
+BOOST_AUTO_TEST_CASE(shouldRejectFramesAboveTheSizeField)
+{
+    // Thrown before anything is allocated
+    BOOST_CHECK_THROW(Frame(Frame::maxSize + 1), std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(shouldMoveTheBuffer)
+{
+    Frame frame(100);
+    void* data = frame.data();
+
+    Frame moved(std::move(frame));
+    BOOST_CHECK(moved.data() == data);
+    BOOST_CHECK_EQUAL(moved.size(), 100);
+    BOOST_CHECK(frame.data() == nullptr);
+    BOOST_CHECK_EQUAL(frame.size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
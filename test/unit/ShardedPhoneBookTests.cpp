@@ -0,0 +1,123 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Stl
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Boost
+#include <boost/test/unit_test.hpp>
+
+// Graybat
+#include <graybat/signaling/ShardedPhoneBook.hpp>
+
+/*******************************************************************************
+ * Sharded Phone Book Tests
+ *******************************************************************************/
+struct ShardedPhoneBookTests {
+
+    ShardedPhoneBookTests()
+        : timeout_(std::chrono::milliseconds(1000))
+    {
+    }
+
+    graybat::signaling::ShardedPhoneBook phoneBook_;
+    std::chrono::milliseconds timeout_;
+};
+
+BOOST_FIXTURE_TEST_SUITE(sharded_phone_book, ShardedPhoneBookTests)
+
+BOOST_AUTO_TEST_CASE(shouldNotFindUnknownContext)
+{
+    BOOST_REQUIRE(phoneBook_.find(0) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(shouldAssignConsecutiveVaddrs)
+{
+    Vaddr vaddr = 0;
+
+    for (Vaddr expected = 0; expected < 3; ++expected) {
+        BOOST_REQUIRE(phoneBook_.insert(7, "data" + std::to_string(expected), "ctrl", vaddr));
+        BOOST_REQUIRE_EQUAL(vaddr, expected);
+    }
+
+    auto book = phoneBook_.find(7);
+    BOOST_REQUIRE(book != nullptr);
+    BOOST_REQUIRE_EQUAL(book->size(), 3);
+    BOOST_REQUIRE_EQUAL(book->at(2).dataUri, "data2");
+    BOOST_REQUIRE(phoneBook_.find(7 + graybat::signaling::ShardedPhoneBook::nShards) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(shouldRegisterConcurrently)
+{
+    const unsigned nThreads = 8;
+    const unsigned nPeers = 2 * graybat::signaling::ContextBook::chunkSize;
+    const unsigned nContexts = 4;
+    std::vector<std::thread> threads;
+
+    for (unsigned thread_i = 0; thread_i < nThreads; ++thread_i) {
+        threads.emplace_back([this, thread_i, nThreads, nPeers, nContexts]() {
+            Vaddr vaddr = 0;
+            for (unsigned peer = thread_i; peer < nPeers; peer += nThreads) {
+                for (ContextId contextId = 0; contextId < nContexts; ++contextId) {
+                    phoneBook_.insert(contextId, std::to_string(peer), "ctrl", vaddr);
+                    phoneBook_.find(contextId);
+                }
+            }
+        });
+    }
+
+    for (ContextId contextId = 0; contextId < nContexts; ++contextId) {
+        auto book = phoneBook_.waitFor(
+            contextId,
+            nPeers,
+            std::chrono::steady_clock::now() + timeout_,
+            []() { return false; });
+        BOOST_REQUIRE(book != nullptr);
+
+        std::set<Uri> uris;
+        for (Vaddr vaddr = 0; vaddr < nPeers; ++vaddr) {
+            uris.insert(book->at(vaddr).dataUri);
+        }
+        BOOST_REQUIRE_EQUAL(uris.size(), nPeers);
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(shouldTimeoutWhenContextIncomplete)
+{
+    Vaddr vaddr = 0;
+    phoneBook_.insert(0, "data", "ctrl", vaddr);
+
+    auto book = phoneBook_.waitFor(
+        0, 2, std::chrono::steady_clock::now() + std::chrono::milliseconds(10), []() {
+            return false;
+        });
+
+    BOOST_REQUIRE(book == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,98 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Stl
+#include <set>
+#include <string>
+
+// Boost
+#include <boost/test/unit_test.hpp>
+
+// Graybat
+#include <graybat/communicationPolicy/socket/SocketPool.hpp>
+
+/*******************************************************************************
+ * Socket Pool Tests
+ *******************************************************************************/
+struct SocketPoolTests {
+
+    SocketPoolTests()
+        : pool_(2)
+        , nConnects_(0)
+    {
+    }
+
+    std::string& get(std::size_t peer)
+    {
+        return pool_.get(
+            peer,
+            [this](std::size_t socket_i) {
+                nConnects_++;
+                return "socket" + std::to_string(socket_i);
+            },
+            [this](std::size_t socket_i) { return pinned_.count(socket_i) == 0; });
+    }
+
+    graybat::communicationPolicy::socket::SocketPool<std::string> pool_;
+    unsigned nConnects_;
+    std::set<std::size_t> pinned_;
+};
+
+BOOST_FIXTURE_TEST_SUITE(socket_pool, SocketPoolTests)
+
+BOOST_AUTO_TEST_CASE(shouldConnectOnFirstUse)
+{
+    BOOST_REQUIRE_EQUAL(get(3), "socket3");
+    BOOST_REQUIRE_EQUAL(get(3), "socket3");
+    BOOST_REQUIRE_EQUAL(nConnects_, 1);
+    BOOST_REQUIRE_EQUAL(pool_.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(shouldEvictLeastRecentlyUsed)
+{
+    get(0);
+    get(1);
+    get(0);
+    get(2);
+
+    BOOST_REQUIRE_EQUAL(pool_.size(), 2);
+
+    // 0 is still pooled, 1 was evicted
+    get(0);
+    BOOST_REQUIRE_EQUAL(nConnects_, 3);
+    get(1);
+    BOOST_REQUIRE_EQUAL(nConnects_, 4);
+}
+
+BOOST_AUTO_TEST_CASE(shouldNotEvictPinnedSockets)
+{
+    pinned_ = { 0, 1 };
+    get(0);
+    get(1);
+    get(2);
+
+    BOOST_REQUIRE_EQUAL(pool_.size(), 3);
+
+    pinned_.clear();
+    get(3);
+    BOOST_REQUIRE_EQUAL(pool_.size(), 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+/**
+ * Copyright 2017 Erik Zenker
+ *
+ * This file is part of Graybat.
+ *
+ * Graybat is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Graybat is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Graybat.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Stl
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+// Boost
+#include <boost/test/unit_test.hpp>
+
+// Graybat
+#include <graybat/communicationPolicy/socket/WireHeader.hpp>
+
+using graybat::communicationPolicy::MsgTypeType;
+using graybat::communicationPolicy::socket::WireHeader;
+
+/*******************************************************************************
+ * Wire Header Tests
+ *******************************************************************************/
+BOOST_AUTO_TEST_SUITE(wire_header)
+
+BOOST_AUTO_TEST_CASE(shouldEncodeSmallHeaderCompactly)
+{
+    WireHeader header{ MsgTypeType::PEER, 3, 1, 2, 5 };
+    std::array<std::int8_t, WireHeader::maxSize> buffer;
+
+    BOOST_REQUIRE_EQUAL(header.encode(buffer.data()), 5);
+    BOOST_REQUIRE_EQUAL(header.encodedSize(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(shouldOmitMsgIDOfNonPeerMessages)
+{
+    WireHeader header{ MsgTypeType::DESTRUCT, 42, 0, 0, 0 };
+    std::array<std::int8_t, WireHeader::maxSize> buffer;
+
+    BOOST_REQUIRE_EQUAL(header.encode(buffer.data()), std::size_t(WireHeader::minSize));
+
+    WireHeader decoded;
+    BOOST_REQUIRE_EQUAL(decoded.decode(buffer.data(), buffer.size()), std::size_t(WireHeader::minSize));
+    BOOST_REQUIRE(decoded.msgType == MsgTypeType::DESTRUCT);
+    BOOST_REQUIRE_EQUAL(decoded.msgID, 0);
+}
+
+BOOST_AUTO_TEST_CASE(shouldRoundTripLargeValues)
+{
+    WireHeader header{ MsgTypeType::CONFIRM, 0xffffffffu, 0x80000000u, 128, 16384 };
+    std::array<std::int8_t, WireHeader::maxSize> buffer;
+    const std::size_t size = header.encode(buffer.data());
+
+    WireHeader decoded;
+    BOOST_REQUIRE_EQUAL(decoded.decode(buffer.data(), size), size);
+    BOOST_REQUIRE(decoded.msgType == MsgTypeType::CONFIRM);
+    BOOST_REQUIRE_EQUAL(decoded.msgID, header.msgID);
+    BOOST_REQUIRE_EQUAL(decoded.contextID, header.contextID);
+    BOOST_REQUIRE_EQUAL(decoded.vAddr, header.vAddr);
+    BOOST_REQUIRE_EQUAL(decoded.tag, header.tag);
+}
+
+BOOST_AUTO_TEST_CASE(shouldRejectTruncatedHeader)
+{
+    WireHeader header{ MsgTypeType::PEER, 1000, 1000, 1000, 1000 };
+    std::array<std::int8_t, WireHeader::maxSize> buffer;
+    const std::size_t size = header.encode(buffer.data());
+
+    WireHeader decoded;
+    BOOST_REQUIRE_THROW(decoded.decode(buffer.data(), size - 1), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(shouldRejectUnknownVersion)
+{
+    std::array<std::int8_t, WireHeader::maxSize> buffer{};
+    buffer[0] = static_cast<std::int8_t>(0xc0);
+
+    WireHeader decoded;
+    BOOST_REQUIRE_THROW(decoded.decode(buffer.data(), buffer.size()), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -21,9 +21,12 @@
 #pragma once
 
 // STL
+#include <cstdlib> /* std::getenv */
 #include <memory>
+#include <string>
 
 // BOOST
+#include <boost/core/ignore_unused.hpp>
 #include <boost/hana/concat.hpp>
 #include <boost/hana/for_each.hpp>
 #include <boost/hana/tuple.hpp>
@@ -36,20 +39,56 @@ namespace graybat {
 namespace test {
 namespace utils {
 
+#ifdef graybat_ZMQ_CP_ENABLED
+/**
+ * @brief ZMQ config of a test context *contextName* over all mpi ranks,
+ *        test cases set the options they exercise on top.
+ */
+inline graybat::communicationPolicy::ZMQ::Config makeZmqConfig(std::string const& contextName)
+{
+    graybat::communicationPolicy::ZMQ::Config config;
+    config.masterUri = "localhost:5000";
+    config.peerUri = "tcp://127.0.0.1:5001";
+    config.contextSize = std::stoi(std::getenv("OMPI_COMM_WORLD_SIZE"));
+    config.contextName = contextName;
+    return config;
+}
+#endif
+
+#ifdef graybat_TCP_CP_ENABLED
+/**
+ * @brief TCP config of a test context *contextName* over all mpi ranks,
+ *        test cases set the options they exercise on top.
+ */
+inline graybat::communicationPolicy::TCP::Config makeTcpConfig(std::string const& contextName)
+{
+    graybat::communicationPolicy::TCP::Config config;
+    config.masterUri = "localhost:5000";
+    config.peerUri = "tcp://127.0.0.1:5001";
+    config.contextSize = std::stoi(std::getenv("OMPI_COMM_WORLD_SIZE"));
+    config.contextName = contextName;
+    return config;
+}
+#endif
+
 auto inline getCommunicationPolicies()
 {
 #ifdef graybat_ZMQ_CP_ENABLED
     using ZMQ = graybat::communicationPolicy::ZMQ;
-    using ZMQConfig = ZMQ::Config;
-    ZMQConfig zmqConfig = { "localhost:5000",
-                            "tcp://127.0.0.1:5001",
-                            static_cast<size_t>(std::stoi(std::getenv("OMPI_COMM_WORLD_SIZE"))),
-                            "context_cp_test" };
+    ZMQ::Config zmqConfig = makeZmqConfig("context_cp_test");
     auto zmq = boost::hana::make_tuple(std::make_shared<ZMQ>(zmqConfig));
 #else
     auto zmq = boost::hana::make_tuple();
 #endif
 
+#ifdef graybat_TCP_CP_ENABLED
+    using TCP = graybat::communicationPolicy::TCP;
+    TCP::Config tcpConfig = makeTcpConfig("context_tcp_cp_test");
+    auto tcp = boost::hana::make_tuple(std::make_shared<TCP>(tcpConfig));
+#else
+    auto tcp = boost::hana::make_tuple();
+#endif
+
 #ifdef graybat_BMPI_CP_ENABLED
     using BMPI = graybat::communicationPolicy::BMPI;
     using BMPIConfig = BMPI::Config;
@@ -58,26 +97,37 @@ auto inline getCommunicationPolicies()
 #else
     auto bmpi = boost::hana::make_tuple();
 #endif
-    return boost::hana::concat(zmq, bmpi);
+    return boost::hana::concat(boost::hana::concat(zmq, tcp), bmpi);
 }
 
-auto inline getCages()
+/**
+ * @brief Cages of all enabled communication policies, each test file
+ *        passes its own *testName*, thus the cages of different files
+ *        join different contexts.
+ */
+auto inline getCages(std::string const& testName)
 {
+    boost::ignore_unused(testName);
     using Serialization = graybat::serializationPolicy::ByteCast;
     using GP = graybat::graphPolicy::BGL<>;
 #ifdef graybat_ZMQ_CP_ENABLED
     using ZMQ = graybat::communicationPolicy::ZMQ;
-    using ZMQConfig = ZMQ::Config;
     using ZMQCage = graybat::Cage<ZMQ, GP, Serialization>;
-    ZMQConfig zmqConfig = { "localhost:5000",
-                            "tcp://127.0.0.1:5001",
-                            static_cast<size_t>(std::stoi(std::getenv("OMPI_COMM_WORLD_SIZE"))),
-                            "context_cp_test" };
+    ZMQ::Config zmqConfig = makeZmqConfig("context_" + testName + "_test");
     auto zmqCage = boost::hana::make_tuple(std::make_shared<ZMQCage>(zmqConfig));
 #else
     auto zmqCage = boost::hana::make_tuple();
 #endif
 
+#ifdef graybat_TCP_CP_ENABLED
+    using TCP = graybat::communicationPolicy::TCP;
+    using TCPCage = graybat::Cage<TCP, GP, Serialization>;
+    TCP::Config tcpConfig = makeTcpConfig("context_" + testName + "_tcp_test");
+    auto tcpCage = boost::hana::make_tuple(std::make_shared<TCPCage>(tcpConfig));
+#else
+    auto tcpCage = boost::hana::make_tuple();
+#endif
+
 #ifdef graybat_BMPI_CP_ENABLED
     using BMPI = graybat::communicationPolicy::BMPI;
     using BMPIConfig = BMPI::Config;
@@ -88,7 +138,7 @@ auto inline getCages()
     auto bmpiCage = boost::hana::make_tuple();
 #endif
 
-    return boost::hana::concat(zmqCage, bmpiCage);
+    return boost::hana::concat(boost::hana::concat(zmqCage, tcpCage), bmpiCage);
 }
 }
 }
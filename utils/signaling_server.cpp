@@ -50,6 +50,9 @@ int main(const int argc, char **argv){
             ("ip",
              po::value<std::string>()->default_value("localhost"),
              "IP to listen for signaling requests. Either ip or interface can be specified. (Example: 127.0.0.1)")
+            ("log-every",
+             po::value<unsigned>()->default_value(100),
+             "Log only every n-th vaddr request and lookup, 0 disables logging of them")
             ("help,h",
              "Print this help message and exit");
 
@@ -73,7 +76,7 @@ int main(const int argc, char **argv){
      **************************************************************************/
     std::cout << "Start grpc signaling server" << std::endl;
 
-    graybat::signaling::GrpcSignalingService service;
+    graybat::signaling::GrpcSignalingService service(vm["log-every"].as<unsigned>());
 
     grpc::ServerBuilder builder;
     builder.AddListeningPort(masterUri, grpc::InsecureServerCredentials());